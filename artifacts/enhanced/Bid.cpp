@@ -1,17 +1,17 @@
-/*
- * File: Bid.cpp
- * Author: Thomas Gallegos
- * Email: N/A
- * Date: July 23, 2024
- * Version: 1.0
- *
- * Purpose:
- * This file implements any non-inline methods of the Bid struct.
- * Currently, it's empty as all Bid functionality is defined in the header.
- *
- * Dependencies:
- * - Bid.h
- *
- */
-
+/*
+ * File: Bid.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file implements any non-inline methods of the Bid struct.
+ * Currently, it's empty as all Bid functionality is defined in the header.
+ *
+ * Dependencies:
+ * - Bid.h
+ *
+ */
+
 #include "Bid.h"
\ No newline at end of file
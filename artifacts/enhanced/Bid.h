@@ -1,44 +1,51 @@
-/*
- * File: Bid.h
- * Author: Thomas Gallegos
- * Email: N/A
- * Date: July 23, 2024
- * Version: 1.0
- *
- * Purpose:
- * This file defines the Bid structure, which represents a single bid in the
- * Bid Management System. It contains all the relevant information for a bid.
- *
- * Dependencies: None
- *
- */
-
-#pragma once
-#include <string>
-
-struct Bid {
-    std::string auctionTitle;
-    std::string auctionId;
-    std::string department;
-    std::string closeDate;
-    double winningBid;
-    double ccFee;
-    double feePercent;
-    double auctionFeeSubtotal;
-    double auctionFeeTotal;
-    std::string payStatus;
-    std::string paidDate;
-    std::string assetNumber;
-    std::string inventoryId;
-    std::string decalVehicleId;
-    std::string vtrNumber;
-    std::string receiptNumber;
-    double cap;
-    double expenses;
-    double netSales;
-    std::string fund;
-    std::string businessUnit;
-
-    // Default constructor initializing numeric fields to 0
-    Bid() : winningBid(0), ccFee(0), feePercent(0), auctionFeeSubtotal(0), auctionFeeTotal(0), cap(0), expenses(0), netSales(0) {}
-};
+/*
+ * File: Bid.h
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file defines the Bid structure, which represents a single bid in the
+ * Bid Management System. It contains all the relevant information for a bid.
+ *
+ * Dependencies:
+ * - InternedString.h for the low-cardinality text fields
+ *
+ */
+
+#pragma once
+#include <string>
+#include <memory>
+#include "InternedString.h"
+
+struct Bid {
+    std::string auctionTitle;
+    std::string auctionId;
+    InternedString department;  // Interned: only a few dozen distinct values
+    std::string closeDate;
+    double winningBid;
+    double ccFee;
+    double feePercent;
+    double auctionFeeSubtotal;
+    double auctionFeeTotal;
+    InternedString payStatus;   // Interned
+    std::string paidDate;
+    std::string assetNumber;
+    std::string inventoryId;
+    std::string decalVehicleId;
+    std::string vtrNumber;
+    std::string receiptNumber;
+    double cap;
+    double expenses;
+    double netSales;
+    InternedString fund;        // Interned
+    InternedString businessUnit;  // Interned
+
+    // Default constructor initializing numeric fields to 0
+    Bid() : winningBid(0), ccFee(0), feePercent(0), auctionFeeSubtotal(0), auctionFeeTotal(0), cap(0), expenses(0), netSales(0) {}
+};
+
+// Bids are shared between the live list and any snapshots taken of it. A shared
+// record is never modified; an update replaces it with a new one.
+typedef std::shared_ptr<const Bid> BidPtr;
\ No newline at end of file
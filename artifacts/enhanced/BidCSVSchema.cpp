@@ -0,0 +1,120 @@
+/*
+ * File: BidCSVSchema.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file implements the BidCSVSchema class, including the table of known
+ * columns and the setter for each.
+ *
+ * Dependencies:
+ * - BidCSVSchema.h
+ *
+ */
+
+#include "BidCSVSchema.h"
+#include <stdexcept>
+
+namespace {
+    ParseStatus setText(std::string& target, std::string_view value) {
+        target.assign(value.data(), value.size());
+        return ParseStatus::Ok;
+    }
+
+    ParseStatus setInterned(InternedString& target, std::string_view value) {
+        return InternedString::TryIntern(value, target) ? ParseStatus::Ok : ParseStatus::TooManyValues;
+    }
+
+    // Position of Auction ID in the field table; it is the only required column
+    const size_t auctionIdField = 1;
+}
+
+// Every column the importer understands, named as in the monthly export
+const BidCSVSchema::Field BidCSVSchema::fields[] = {
+    { "Auction Title", [](std::string_view v, Bid& b) { return setText(b.auctionTitle, v); } },
+    { "Auction ID", [](std::string_view v, Bid& b) { return setText(b.auctionId, v); } },
+    { "Department", [](std::string_view v, Bid& b) { return setInterned(b.department, v); } },
+    { "Close Date", [](std::string_view v, Bid& b) { return setText(b.closeDate, v); } },
+    { "Winning Bid", [](std::string_view v, Bid& b) { return parseMoney(v, b.winningBid); } },
+    { "CC Fee", [](std::string_view v, Bid& b) { return parseMoney(v, b.ccFee); } },
+    { "Fee Percent", [](std::string_view v, Bid& b) { return parsePercent(v, b.feePercent); } },
+    { "Auction Fee Subtotal", [](std::string_view v, Bid& b) { return parseMoney(v, b.auctionFeeSubtotal); } },
+    { "Auction Fee Total", [](std::string_view v, Bid& b) { return parseMoney(v, b.auctionFeeTotal); } },
+    { "Pay Status", [](std::string_view v, Bid& b) { return setInterned(b.payStatus, v); } },
+    { "Paid Date", [](std::string_view v, Bid& b) { return setText(b.paidDate, v); } },
+    { "Asset #", [](std::string_view v, Bid& b) { return setText(b.assetNumber, v); } },
+    { "Inventory ID", [](std::string_view v, Bid& b) { return setText(b.inventoryId, v); } },
+    { "Decal /Vehicle ID", [](std::string_view v, Bid& b) { return setText(b.decalVehicleId, v); } },
+    { "VTR Number", [](std::string_view v, Bid& b) { return setText(b.vtrNumber, v); } },
+    { "Receipt Number", [](std::string_view v, Bid& b) { return setText(b.receiptNumber, v); } },
+    { "Cap", [](std::string_view v, Bid& b) { return parseMoney(v, b.cap); } },
+    { "Expenses", [](std::string_view v, Bid& b) { return parseMoney(v, b.expenses); } },
+    { "Net Sales", [](std::string_view v, Bid& b) { return parseMoney(v, b.netSales); } },
+    { "Fund", [](std::string_view v, Bid& b) { return setInterned(b.fund, v); } },
+    { "Business Unit", [](std::string_view v, Bid& b) { return setInterned(b.businessUnit, v); } }
+};
+
+const size_t BidCSVSchema::fieldCount = sizeof(BidCSVSchema::fields) / sizeof(BidCSVSchema::fields[0]);
+
+// Lower-case a column name and drop everything but letters and digits
+std::string BidCSVSchema::NormalizeName(std::string_view name) {
+    std::string normalized;
+    normalized.reserve(name.size());
+    for (char c : name) {
+        if (c >= 'A' && c <= 'Z') {
+            normalized.push_back(static_cast<char>(c - 'A' + 'a'));
+        }
+        else if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) {
+            normalized.push_back(c);
+        }
+    }
+    return normalized;
+}
+
+// Resolve a header to field setters
+BidCSVSchema::BidCSVSchema(const std::vector<std::string>& header) {
+    std::vector<bool> bound(fieldCount, false);
+
+    for (unsigned int column = 0; column < header.size(); column++) {
+        std::string name = NormalizeName(header[column]);
+
+        size_t match = fieldCount;
+        for (size_t f = 0; f < fieldCount; f++) {
+            if (!bound[f] && NormalizeName(fields[f].name) == name) {
+                match = f;
+                break;
+            }
+        }
+
+        if (match == fieldCount) {
+            ignoredColumns.push_back(header[column]);
+            continue;
+        }
+        bound[match] = true;
+        bindings.push_back(Binding{ column, &fields[match] });
+    }
+
+    for (size_t f = 0; f < fieldCount; f++) {
+        if (!bound[f]) {
+            missingFields.push_back(fields[f].name);
+        }
+    }
+
+    if (!bound[auctionIdField]) {
+        throw std::runtime_error("CSV header has no Auction ID column");
+    }
+}
+
+// Fill bid from a row of the bound file
+bool BidCSVSchema::Apply(const csv::RowView& row, Bid& bid, std::string& error) const {
+    for (const Binding& binding : bindings) {
+        ParseStatus status = binding.field->setter(row[binding.column], bid);
+        if (status != ParseStatus::Ok) {
+            error = std::string(binding.field->name) + " is " + parseStatusMessage(status);
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,72 @@
+/*
+ * File: BidCSVSchema.h
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file defines the BidCSVSchema class, which binds the columns of a CSV
+ * export to Bid fields by header name. The header is resolved once per file: each
+ * column name is normalized (case, spaces and punctuation are ignored, so
+ * "Auction Title " matches "auction title") and paired with a setter for its
+ * field. Rows are then filled by walking that table, with no per-field name lookup.
+ * Exports whose columns are reordered, extra or missing are imported as long as
+ * the auction ID column is present; missing fields keep their defaults.
+ *
+ * Dependencies:
+ * - Bid.h for the Bid structure
+ * - CSVparser.h for the rows being bound
+ * - NumberParsing.h for the numeric columns
+ *
+ */
+
+#pragma once
+#include "Bid.h"
+#include "CSVparser.h"
+#include "NumberParsing.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+class BidCSVSchema {
+public:
+    // Resolve a header to field setters. Throws std::runtime_error if there is
+    // no auction ID column.
+    explicit BidCSVSchema(const std::vector<std::string>& header);
+
+    // Fill bid from a row of the bound file. Returns false, with a description
+    // in error, if a numeric column does not parse.
+    bool Apply(const csv::RowView& row, Bid& bid, std::string& error) const;
+
+    // Fields that no column was bound to
+    const std::vector<std::string>& MissingFields() const { return missingFields; }
+
+    // Header columns that did not match any field
+    const std::vector<std::string>& IgnoredColumns() const { return ignoredColumns; }
+
+    // Lower-case a column name and drop everything but letters and digits
+    static std::string NormalizeName(std::string_view name);
+
+private:
+    typedef ParseStatus (*Setter)(std::string_view value, Bid& bid);
+
+    // One known Bid field and how to set it
+    struct Field {
+        const char* name;   // Display name, as in the monthly export
+        Setter setter;
+    };
+
+    // One bound column
+    struct Binding {
+        unsigned int column;
+        const Field* field;
+    };
+
+    static const Field fields[];
+    static const size_t fieldCount;
+
+    std::vector<Binding> bindings;
+    std::vector<std::string> missingFields;
+    std::vector<std::string> ignoredColumns;
+};
@@ -0,0 +1,318 @@
+/*
+ * File: BidColumnStore.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file implements the BidColumnStore class, the columnar copy of the bid data
+ * used for aggregate reports over the numeric fields.
+ *
+ * The scan loops are written with several independent accumulators and without
+ * branches so that the compiler can vectorize them without relaxed floating-point
+ * settings.
+ *
+ * Dependencies:
+ * - BidColumnStore.h
+ *
+ */
+
+#include "BidColumnStore.h"
+#include <stdexcept>
+
+BidColumnStore::BidColumnStore() {}
+
+// Overwrite every column of an existing row from a bid
+void BidColumnStore::writeRow(size_t row, const Bid& bid) {
+    numeric[WinningBid][row] = bid.winningBid;
+    numeric[CcFee][row] = bid.ccFee;
+    numeric[FeePercent][row] = bid.feePercent;
+    numeric[AuctionFeeSubtotal][row] = bid.auctionFeeSubtotal;
+    numeric[AuctionFeeTotal][row] = bid.auctionFeeTotal;
+    numeric[Cap][row] = bid.cap;
+    numeric[Expenses][row] = bid.expenses;
+    numeric[NetSales][row] = bid.netSales;
+
+    groups[Department][row] = bid.department.Code();
+    groups[PayStatus][row] = bid.payStatus.Code();
+    groups[Fund][row] = bid.fund.Code();
+    groups[BusinessUnit][row] = bid.businessUnit.Code();
+}
+
+// Add a bid as a new row, or overwrite its row if the auction ID is already present
+void BidColumnStore::Append(const Bid& bid) {
+    const uint32_t* existing = rowOf.Find(bid.auctionId);
+    if (existing != nullptr) {
+        writeRow(*existing, bid);
+        return;
+    }
+
+    size_t row = auctionIds.size();
+    for (std::vector<double>& column : numeric) {
+        column.push_back(0);
+    }
+    for (std::vector<uint32_t>& column : groups) {
+        column.push_back(0);
+    }
+    auctionIds.push_back(bid.auctionId);
+    rowOf.Insert(bid.auctionId, static_cast<uint32_t>(row));
+    writeRow(row, bid);
+}
+
+// Replace the values stored for a bid
+void BidColumnStore::Update(const Bid& bid) {
+    Append(bid);
+}
+
+// Remove a bid by moving the last row into its place
+void BidColumnStore::Remove(const std::string& auctionId) {
+    const uint32_t* found = rowOf.Find(auctionId);
+    if (found == nullptr) {
+        return;
+    }
+
+    size_t row = *found;
+    size_t last = auctionIds.size() - 1;
+    if (row != last) {
+        for (std::vector<double>& column : numeric) {
+            column[row] = column[last];
+        }
+        for (std::vector<uint32_t>& column : groups) {
+            column[row] = column[last];
+        }
+        auctionIds[row] = std::move(auctionIds[last]);
+        rowOf.Insert(auctionIds[row], static_cast<uint32_t>(row));
+    }
+
+    for (std::vector<double>& column : numeric) {
+        column.pop_back();
+    }
+    for (std::vector<uint32_t>& column : groups) {
+        column.pop_back();
+    }
+    auctionIds.pop_back();
+    rowOf.Erase(auctionId);
+}
+
+// Drop every row
+void BidColumnStore::Clear() {
+    for (std::vector<double>& column : numeric) {
+        column.clear();
+    }
+    for (std::vector<uint32_t>& column : groups) {
+        column.clear();
+    }
+    auctionIds.clear();
+    rowOf.Clear();
+}
+
+// Pre-size every column for a bulk load
+void BidColumnStore::Reserve(size_t rows) {
+    for (std::vector<double>& column : numeric) {
+        column.reserve(rows);
+    }
+    for (std::vector<uint32_t>& column : groups) {
+        column.reserve(rows);
+    }
+    auctionIds.reserve(rows);
+    rowOf.Reserve(rows);
+}
+
+size_t BidColumnStore::Size() const {
+    return auctionIds.size();
+}
+
+// Sum of a numeric column over every row
+double BidColumnStore::Sum(NumericColumn column) const {
+    const double* values = numeric[column].data();
+    size_t n = numeric[column].size();
+
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += values[i];
+        s1 += values[i + 1];
+        s2 += values[i + 2];
+        s3 += values[i + 3];
+    }
+    for (; i < n; i++) {
+        s0 += values[i];
+    }
+
+    return (s0 + s1) + (s2 + s3);
+}
+
+// Sum of a numeric column over the rows whose group column equals value
+double BidColumnStore::SumWhere(GroupColumn group, const std::string& value, NumericColumn column) const {
+    uint32_t code = InternedString::Find(value);
+    if (code == InternedString::NotFound) {
+        return 0;
+    }
+
+    const double* values = numeric[column].data();
+    const uint32_t* codes = groups[group].data();
+    size_t n = numeric[column].size();
+
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += (codes[i] == code) ? values[i] : 0.0;
+        s1 += (codes[i + 1] == code) ? values[i + 1] : 0.0;
+        s2 += (codes[i + 2] == code) ? values[i + 2] : 0.0;
+        s3 += (codes[i + 3] == code) ? values[i + 3] : 0.0;
+    }
+    for (; i < n; i++) {
+        s0 += (codes[i] == code) ? values[i] : 0.0;
+    }
+
+    return (s0 + s1) + (s2 + s3);
+}
+
+// Sum of a numeric column for each distinct value of a group column
+std::vector<std::pair<std::string, double>> BidColumnStore::SumBy(GroupColumn group, NumericColumn column) const {
+    // Codes come from the shared string pool, so every code in the column is below its size
+    size_t codeCount = InternedString::PoolSize();
+    std::vector<double> sums(codeCount, 0.0);
+    std::vector<uint32_t> counts(codeCount, 0);
+
+    const double* values = numeric[column].data();
+    const uint32_t* codes = groups[group].data();
+    size_t n = numeric[column].size();
+    for (size_t i = 0; i < n; i++) {
+        sums[codes[i]] += values[i];
+        counts[codes[i]]++;
+    }
+
+    // Only report values that still occur in at least one row
+    std::vector<std::pair<std::string, double>> totals;
+    for (uint32_t code = 0; code < sums.size(); code++) {
+        if (counts[code] > 0) {
+            totals.emplace_back(InternedString::Lookup(code), sums[code]);
+        }
+    }
+    return totals;
+}
+
+// Value of a numeric column for one bid
+double BidColumnStore::NumericValue(const Bid& bid, NumericColumn column) {
+    switch (column) {
+    case WinningBid: return bid.winningBid;
+    case CcFee: return bid.ccFee;
+    case FeePercent: return bid.feePercent;
+    case AuctionFeeSubtotal: return bid.auctionFeeSubtotal;
+    case AuctionFeeTotal: return bid.auctionFeeTotal;
+    case Cap: return bid.cap;
+    case Expenses: return bid.expenses;
+    case NetSales: return bid.netSales;
+    default: throw std::invalid_argument("Unknown numeric column");
+    }
+}
+
+// InternedString code of a group column for one bid
+uint32_t BidColumnStore::GroupCode(const Bid& bid, GroupColumn column) {
+    switch (column) {
+    case Department: return bid.department.Code();
+    case PayStatus: return bid.payStatus.Code();
+    case Fund: return bid.fund.Code();
+    case BusinessUnit: return bid.businessUnit.Code();
+    default: throw std::invalid_argument("Unknown group column");
+    }
+}
+
+// Value of a date column for one bid as YYYYMMDD
+uint32_t BidColumnStore::DateValue(const Bid& bid, DateColumn column) {
+    switch (column) {
+    case CloseDate: return ParseDate(bid.closeDate);
+    case PaidDate: return ParseDate(bid.paidDate);
+    default: throw std::invalid_argument("Unknown date column");
+    }
+}
+
+// A MM/DD/YYYY date as YYYYMMDD, or 0 when it is not a valid date
+uint32_t BidColumnStore::ParseDate(std::string_view text) {
+    // Month and day may be written with one digit or two
+    uint32_t parts[3] = { 0, 0, 0 };
+    size_t part = 0;
+    size_t digits = 0;
+    for (char c : text) {
+        if (c >= '0' && c <= '9') {
+            if (++digits > 4) {
+                return 0;
+            }
+            parts[part] = parts[part] * 10 + static_cast<uint32_t>(c - '0');
+        }
+        else if (c == '/' && part < 2 && digits > 0) {
+            part++;
+            digits = 0;
+        }
+        else {
+            return 0;
+        }
+    }
+
+    uint32_t month = parts[0];
+    uint32_t day = parts[1];
+    uint32_t year = parts[2];
+    if (part != 2 || digits != 4 || month < 1 || month > 12 || day < 1 || day > 31) {
+        return 0;
+    }
+    return year * 10000 + month * 100 + day;
+}
+
+// Map a report column name to a numeric column
+bool BidColumnStore::ParseNumericColumn(const std::string& name, NumericColumn& column) {
+    static const char* const names[NumericColumnCount] = {
+        "winningBid", "ccFee", "feePercent", "auctionFeeSubtotal",
+        "auctionFeeTotal", "cap", "expenses", "netSales"
+    };
+    for (int i = 0; i < NumericColumnCount; i++) {
+        if (name == names[i]) {
+            column = static_cast<NumericColumn>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Map a report column name to a group column
+bool BidColumnStore::ParseGroupColumn(const std::string& name, GroupColumn& column) {
+    static const char* const names[GroupColumnCount] = {
+        "department", "payStatus", "fund", "businessUnit"
+    };
+    for (int i = 0; i < GroupColumnCount; i++) {
+        if (name == names[i]) {
+            column = static_cast<GroupColumn>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Map a column name to a date column
+bool BidColumnStore::ParseDateColumn(const std::string& name, DateColumn& column) {
+    static const char* const names[DateColumnCount] = {
+        "closeDate", "paidDate"
+    };
+    for (int i = 0; i < DateColumnCount; i++) {
+        if (name == names[i]) {
+            column = static_cast<DateColumn>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Map a column name to an identifier column
+bool BidColumnStore::ParseIdentifierColumn(const std::string& name, IdentifierColumn& column) {
+    static const char* const names[IdentifierColumnCount] = {
+        "auctionId", "assetNumber", "receiptNumber", "vtrNumber"
+    };
+    for (int i = 0; i < IdentifierColumnCount; i++) {
+        if (name == names[i]) {
+            column = static_cast<IdentifierColumn>(i);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,120 @@
+/*
+ * File: BidColumnStore.h
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file defines the BidColumnStore class, a columnar (struct-of-arrays) copy
+ * of the bid data kept next to the LinkedList for analytics. Each numeric field is
+ * stored in its own contiguous array of doubles, and the low-cardinality text fields
+ * are dictionary-encoded as arrays of 32-bit codes. Aggregates such as revenue per
+ * department or fund then stream through only the columns they need.
+ *
+ * Rows are kept dense: removing a bid moves the last row into its place, so row
+ * numbers are not stable and are never handed out to callers.
+ *
+ * Dependencies:
+ * - Bid.h for the Bid structure
+ * - HashIndex.h for the auction ID to row lookup
+ * - InternedString.h, whose pool codes are stored in the encoded text columns
+ *
+ */
+
+#pragma once
+#include "Bid.h"
+#include "HashIndex.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+class BidColumnStore {
+public:
+    // Numeric columns
+    enum NumericColumn {
+        WinningBid,
+        CcFee,
+        FeePercent,
+        AuctionFeeSubtotal,
+        AuctionFeeTotal,
+        Cap,
+        Expenses,
+        NetSales,
+        NumericColumnCount
+    };
+
+    // Dictionary-encoded text columns that reports can group or filter by
+    enum GroupColumn {
+        Department,
+        PayStatus,
+        Fund,
+        BusinessUnit,
+        GroupColumnCount
+    };
+
+    // Date columns, which queries can sort and range-filter by
+    enum DateColumn {
+        CloseDate,
+        PaidDate,
+        DateColumnCount
+    };
+
+    // Identifier columns, which have an autocomplete index
+    enum IdentifierColumn {
+        AuctionId,
+        AssetNumber,
+        ReceiptNumber,
+        VtrNumber,
+        IdentifierColumnCount
+    };
+
+    BidColumnStore();
+
+    // Keep the store in step with the row store
+    void Append(const Bid& bid);
+    void Update(const Bid& bid);
+    void Remove(const std::string& auctionId);
+    void Clear();
+    void Reserve(size_t rows);
+    size_t Size() const;
+
+    // Sum of a numeric column over every row
+    double Sum(NumericColumn column) const;
+
+    // Sum of a numeric column over the rows whose group column equals value
+    double SumWhere(GroupColumn group, const std::string& value, NumericColumn column) const;
+
+    // Sum of a numeric column for each distinct value of a group column
+    std::vector<std::pair<std::string, double>> SumBy(GroupColumn group, NumericColumn column) const;
+
+    // Value of a numeric column for one bid
+    static double NumericValue(const Bid& bid, NumericColumn column);
+
+    // InternedString code of a group column for one bid
+    static uint32_t GroupCode(const Bid& bid, GroupColumn column);
+
+    // Value of a date column for one bid as YYYYMMDD, which orders chronologically;
+    // 0 when the date is empty or malformed
+    static uint32_t DateValue(const Bid& bid, DateColumn column);
+
+    // A MM/DD/YYYY date as YYYYMMDD, or 0 when it is not a valid date
+    static uint32_t ParseDate(std::string_view text);
+
+    // Column names as used in reports and query strings, e.g. "netSales" or "fund"
+    static bool ParseNumericColumn(const std::string& name, NumericColumn& column);
+    static bool ParseGroupColumn(const std::string& name, GroupColumn& column);
+    static bool ParseDateColumn(const std::string& name, DateColumn& column);
+    static bool ParseIdentifierColumn(const std::string& name, IdentifierColumn& column);
+
+private:
+    std::vector<double> numeric[NumericColumnCount];
+    std::vector<uint32_t> groups[GroupColumnCount];  // InternedString codes
+    std::vector<std::string> auctionIds;
+    HashIndex<uint32_t> rowOf;
+
+    // Overwrite every column of an existing row from a bid
+    void writeRow(size_t row, const Bid& bid);
+};
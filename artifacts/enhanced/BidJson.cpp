@@ -0,0 +1,167 @@
+/*
+ * File: BidJson.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file implements the BidJson serializer.
+ *
+ * Dependencies:
+ * - BidJson.h
+ *
+ */
+
+#include "BidJson.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace {
+    // Escape to write after a backslash for each byte, or 0 for bytes copied as they are
+    struct EscapeTable {
+        char code[256];
+
+        constexpr EscapeTable() : code() {
+            for (int c = 0; c < 0x20; c++) {
+                code[c] = 'u';
+            }
+            code[static_cast<unsigned char>('\b')] = 'b';
+            code[static_cast<unsigned char>('\f')] = 'f';
+            code[static_cast<unsigned char>('\n')] = 'n';
+            code[static_cast<unsigned char>('\r')] = 'r';
+            code[static_cast<unsigned char>('\t')] = 't';
+            code[static_cast<unsigned char>('"')] = '"';
+            code[static_cast<unsigned char>('\\')] = '\\';
+        }
+    };
+
+    constexpr EscapeTable escapes;
+
+    // Append a string literal without measuring it at run time
+    template <size_t N>
+    void appendLiteral(std::string& out, const char (&text)[N]) {
+        out.append(text, N - 1);
+    }
+
+    // Bids serialized to estimate the size of a listing
+    const size_t estimateSample = 64;
+}
+
+// Append a JSON string literal, quotes included
+void BidJson::AppendString(std::string& out, std::string_view value) {
+    static const char hexDigits[] = "0123456789abcdef";
+
+    out.push_back('"');
+    const char* run = value.data();
+    const char* end = value.data() + value.size();
+    for (const char* p = run; p != end; ++p) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        char code = escapes.code[c];
+        if (code == 0) {
+            continue;
+        }
+
+        // Copy the plain characters before this one in one go, then the escape
+        out.append(run, p - run);
+        out.push_back('\\');
+        out.push_back(code);
+        if (code == 'u') {
+            appendLiteral(out, "00");
+            out.push_back(hexDigits[c >> 4]);
+            out.push_back(hexDigits[c & 0x0F]);
+        }
+        run = p + 1;
+    }
+    out.append(run, end - run);
+    out.push_back('"');
+}
+
+// Append a JSON number, using the shortest text that reads back as the same double
+void BidJson::AppendNumber(std::string& out, double value) {
+    if (!std::isfinite(value)) {
+        appendLiteral(out, "null");
+        return;
+    }
+    char buffer[32];
+    std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr - buffer);
+}
+
+// Append one bid as a JSON object
+void BidJson::Append(std::string& out, const Bid& bid) {
+    appendLiteral(out, "{\"auctionTitle\":");
+    AppendString(out, bid.auctionTitle);
+    appendLiteral(out, ",\"auctionId\":");
+    AppendString(out, bid.auctionId);
+    appendLiteral(out, ",\"department\":");
+    AppendString(out, bid.department.str());
+    appendLiteral(out, ",\"closeDate\":");
+    AppendString(out, bid.closeDate);
+    appendLiteral(out, ",\"winningBid\":");
+    AppendNumber(out, bid.winningBid);
+    appendLiteral(out, ",\"ccFee\":");
+    AppendNumber(out, bid.ccFee);
+    appendLiteral(out, ",\"feePercent\":");
+    AppendNumber(out, bid.feePercent);
+    appendLiteral(out, ",\"auctionFeeSubtotal\":");
+    AppendNumber(out, bid.auctionFeeSubtotal);
+    appendLiteral(out, ",\"auctionFeeTotal\":");
+    AppendNumber(out, bid.auctionFeeTotal);
+    appendLiteral(out, ",\"payStatus\":");
+    AppendString(out, bid.payStatus.str());
+    appendLiteral(out, ",\"paidDate\":");
+    AppendString(out, bid.paidDate);
+    appendLiteral(out, ",\"assetNumber\":");
+    AppendString(out, bid.assetNumber);
+    appendLiteral(out, ",\"inventoryId\":");
+    AppendString(out, bid.inventoryId);
+    appendLiteral(out, ",\"decalVehicleId\":");
+    AppendString(out, bid.decalVehicleId);
+    appendLiteral(out, ",\"vtrNumber\":");
+    AppendString(out, bid.vtrNumber);
+    appendLiteral(out, ",\"receiptNumber\":");
+    AppendString(out, bid.receiptNumber);
+    appendLiteral(out, ",\"cap\":");
+    AppendNumber(out, bid.cap);
+    appendLiteral(out, ",\"expenses\":");
+    AppendNumber(out, bid.expenses);
+    appendLiteral(out, ",\"netSales\":");
+    AppendNumber(out, bid.netSales);
+    appendLiteral(out, ",\"fund\":");
+    AppendString(out, bid.fund.str());
+    appendLiteral(out, ",\"businessUnit\":");
+    AppendString(out, bid.businessUnit.str());
+    out.push_back('}');
+}
+
+// Append every bid in the view as a JSON array of objects
+void BidJson::AppendArray(std::string& out, const BidView& bids) {
+    out.push_back('[');
+    for (size_t i = 0; i < bids.size(); i++) {
+        if (i > 0) {
+            out.push_back(',');
+        }
+        Append(out, bids[i]);
+    }
+    out.push_back(']');
+}
+
+// Rough serialized size of the bids in a view, from a sample of evenly spaced bids
+size_t BidJson::EstimateSize(const BidView& bids) {
+    if (bids.size() == 0) {
+        return 2;
+    }
+
+    size_t sample = std::min(bids.size(), estimateSample);
+    size_t step = bids.size() / sample;
+    std::string scratch;
+    for (size_t i = 0; i < sample; i++) {
+        Append(scratch, bids[i * step]);
+    }
+
+    // Leave some headroom so a slightly larger than average listing does not reallocate
+    size_t perBid = scratch.size() / sample + 1;
+    return bids.size() * perBid + bids.size() / 8 + 2;
+}
@@ -0,0 +1,44 @@
+/*
+ * File: BidJson.h
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file defines the BidJson class, a hand-written JSON serializer for bids.
+ * It appends straight to an output string instead of building a crow::json::wvalue
+ * tree first, so a listing of every bid costs one pass and one buffer: the text of
+ * the response. The object keys and separators between fields are fixed strings,
+ * string escaping is driven by a lookup table and copies runs of plain characters
+ * in one go, and numbers are written with std::to_chars.
+ *
+ * Dependencies:
+ * - Bid.h for the Bid structure
+ * - BidSnapshot.h for the views being serialized
+ *
+ */
+
+#pragma once
+#include "Bid.h"
+#include "BidSnapshot.h"
+#include <string>
+#include <string_view>
+
+class BidJson {
+public:
+    // Append one bid as a JSON object
+    static void Append(std::string& out, const Bid& bid);
+
+    // Append every bid in the view as a JSON array of objects
+    static void AppendArray(std::string& out, const BidView& bids);
+
+    // Append a JSON string literal, quotes included
+    static void AppendString(std::string& out, std::string_view value);
+
+    // Append a JSON number; NaN and infinities, which JSON cannot represent, become null
+    static void AppendNumber(std::string& out, double value);
+
+    // Rough serialized size of the bids in a view, for reserving the output buffer
+    static size_t EstimateSize(const BidView& bids);
+};
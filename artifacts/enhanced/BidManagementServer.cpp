@@ -1,474 +1,719 @@
-/*
- * File: BidManagementServer.cpp
- * Author: Thomas Gallegos
- * Email: N/A
- * Date: July 23, 2024
- * Version: 1.0
- *
- * Purpose:
- * This file implements the main server functionality for the Bid Management System.
- * It sets up the HTTP server, defines API endpoints, and handles user authentication
- * and bid management operations.
- *
- * Dependencies:
- * - crow framework for HTTP server
- * - DatabaseManager for data persistence
- * - JWT for token-based authentication
- * 
- */
-
-#include "crow.h"
-#include "crow/middleware.h"
-#include "DatabaseManager.h"
-#include "Bid.h"
-#include "User.h"
-#include "Utils.h"
-#include "TOTP.h"
-#include <vector>
-#include <stdexcept>
-#include <jwt-cpp/jwt.h>
-
-
- // Function to validate the input JSON for a bid
-bool validateBidInput(const crow::json::rvalue& json) {
-
-    // Check if all required fields are present and have the correct types
-    return json.has("auctionTitle") && json.has("auctionId") && json.has("department") &&
-        json.has("closeDate") && json.has("winningBid") && json.has("ccFee") &&
-        json.has("feePercent") && json.has("auctionFeeSubtotal") && json.has("auctionFeeTotal") &&
-        json.has("payStatus") && json.has("paidDate") && json.has("assetNumber") &&
-        json.has("inventoryId") && json.has("decalVehicleId") && json.has("vtrNumber") &&
-        json.has("receiptNumber") && json.has("cap") && json.has("expenses") &&
-        json.has("netSales") && json.has("fund") && json.has("businessUnit") &&
-        json["auctionTitle"].t() == crow::json::type::String &&
-        json["auctionId"].t() == crow::json::type::String &&
-        json["department"].t() == crow::json::type::String &&
-        json["closeDate"].t() == crow::json::type::String &&
-        json["winningBid"].t() == crow::json::type::Number &&
-        json["ccFee"].t() == crow::json::type::Number &&
-        json["feePercent"].t() == crow::json::type::Number &&
-        json["auctionFeeSubtotal"].t() == crow::json::type::Number &&
-        json["auctionFeeTotal"].t() == crow::json::type::Number &&
-        json["payStatus"].t() == crow::json::type::String &&
-        json["paidDate"].t() == crow::json::type::String &&
-        json["assetNumber"].t() == crow::json::type::String &&
-        json["inventoryId"].t() == crow::json::type::String &&
-        json["decalVehicleId"].t() == crow::json::type::String &&
-        json["vtrNumber"].t() == crow::json::type::String &&
-        json["receiptNumber"].t() == crow::json::type::String &&
-        json["cap"].t() == crow::json::type::Number &&
-        json["expenses"].t() == crow::json::type::Number &&
-        json["netSales"].t() == crow::json::type::Number &&
-        json["fund"].t() == crow::json::type::String &&
-        json["businessUnit"].t() == crow::json::type::String;
-}
-
-// Function to create a JWT token for authenticated users
-std::string createToken(const std::string& username) {
-    // Create a JWT token with a 1-hour expiration time
-    auto token = jwt::create()
-        .set_issuer("auth0")
-        .set_type("JWS")
-        .set_payload_claim("username", jwt::claim(username))
-        .set_issued_at(std::chrono::system_clock::now())
-        .set_expires_at(std::chrono::system_clock::now() + std::chrono::hours{ 1 })
-        .sign(jwt::algorithm::hs256{ "secret" });
-    return token;
-}
-
-// Function to verify the JWT token
-bool verifyToken(const std::string& token) {
-    try {
-        // Decode and verify the token
-        auto decoded = jwt::decode(token);
-        auto verifier = jwt::verify()
-            .allow_algorithm(jwt::algorithm::hs256{ "secret" })
-            .with_issuer("auth0");
-        verifier.verify(decoded);
-        return true;
-    }
-    catch (const std::exception&) {
-        return false;
-    }
-}
-
-int main()
-{
-    crow::SimpleApp app;
-    DatabaseManager dbManager;
-
-    // Initialize the database
-    try {
-        dbManager.init();
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Failed to initialize database: " << e.what() << std::endl;
-        return 1;
-    }
-    
-    // Define routes and their handlers
-
-    // Root route
-    CROW_ROUTE(app, "/")([]() {
-        return crow::response("Welcome to the Bid Management System!");
-    });
-
-    // User registration route
-    CROW_ROUTE(app, "/register")
-        .methods("POST"_method)
-        ([&dbManager](const crow::request& req) {
-        auto x = crow::json::load(req.body);
-        if (!x) {
-            return crow::response(400, "Invalid JSON");
-        }
-        if (!x.has("username") || !x.has("password")) {
-            return crow::response(400, "Missing username or password");
-        }
-        try {
-            User user;
-            user.username = x["username"].s();
-            user.passwordHash = hashPassword(x["password"].s());
-            dbManager.addUser(user);
-            return crow::response(201, "User registered successfully");
-        }
-        catch (const std::exception& e) {
-            return crow::response(500, std::string("Internal server error: ") + e.what());
-        }
-    });
-
-
-    // User login route
-    CROW_ROUTE(app, "/login")
-        .methods("POST"_method)
-        ([&dbManager](const crow::request& req) {
-        auto x = crow::json::load(req.body);
-        if (!x) {
-            return crow::response(400, "Invalid JSON");
-        }
-        if (!x.has("username") || !x.has("password")) {
-            return crow::response(400, "Missing username or password");
-        }
-        try {
-            if (dbManager.validateUser(x["username"].s(), x["password"].s())) {
-                std::string token = createToken(x["username"].s());
-                std::cout << "Generated token: " << token << std::endl;  // Log the generated token
-                return crow::response(200, token);
-            }
-            else {
-                return crow::response(401, "Invalid username or password");
-            }
-        }
-        catch (const std::exception& e) {
-            return crow::response(500, std::string("Internal server error: ") + e.what());
-        }
-    });
-
-    // Middleware for token verification
-    struct TokenVerifier {
-        bool before(crow::request& req) {
-            std::cout << "TokenVerifier: Checking authorization" << std::endl;
-            auto auth_header = req.get_header_value("Authorization");
-            std::cout << "TokenVerifier: Auth header: " << auth_header << std::endl;
-
-            if (auth_header.empty() || auth_header.substr(0, 7) != "Bearer ") {
-                std::cout << "TokenVerifier: Invalid Authorization header format" << std::endl;
-                return false;
-            }
-
-            std::string token = auth_header.substr(7);
-            std::cout << "TokenVerifier: Extracted token: " << token << std::endl;
-
-            bool is_valid = verifyToken(token);
-            std::cout << "TokenVerifier: Token validity: " << (is_valid ? "valid" : "invalid") << std::endl;
-
-            return is_valid;
-        }
-    };
-
-    // CSV import route
-    CROW_ROUTE(app, "/import-csv")
-        .methods("POST"_method)
-        .middlewares<TokenVerifier>()
-        ([&dbManager](const crow::request& req) {
-        auto x = crow::json::load(req.body);
-        if (!x || !x.has("filename")) {
-            return crow::response(400, "Invalid JSON or missing filename");
-        }
-
-        try {
-            dbManager.importFromCSV(x["filename"].s());
-            return crow::response(200, "CSV data imported successfully");
-        }
-        catch (const std::exception& e) {
-            return crow::response(500, std::string("Error importing CSV: ") + e.what());
-        }
-    });
-
-    // Get all bids route
-    CROW_ROUTE(app, "/bids")
-        .methods("GET"_method)
-        .middlewares<TokenVerifier>()
-        ([&dbManager]() {
-        try {
-            std::vector<Bid> bids = dbManager.getAllBids();
-            crow::json::wvalue response;
-            for (size_t i = 0; i < bids.size(); i++) {
-                response[i] = {
-                    {"auctionTitle", bids[i].auctionTitle},
-                    {"auctionId", bids[i].auctionId},
-                    {"department", bids[i].department},
-                    {"closeDate", bids[i].closeDate},
-                    {"winningBid", bids[i].winningBid},
-                    {"ccFee", bids[i].ccFee},
-                    {"feePercent", bids[i].feePercent},
-                    {"auctionFeeSubtotal", bids[i].auctionFeeSubtotal},
-                    {"auctionFeeTotal", bids[i].auctionFeeTotal},
-                    {"payStatus", bids[i].payStatus},
-                    {"paidDate", bids[i].paidDate},
-                    {"assetNumber", bids[i].assetNumber},
-                    {"inventoryId", bids[i].inventoryId},
-                    {"decalVehicleId", bids[i].decalVehicleId},
-                    {"vtrNumber", bids[i].vtrNumber},
-                    {"receiptNumber", bids[i].receiptNumber},
-                    {"cap", bids[i].cap},
-                    {"expenses", bids[i].expenses},
-                    {"netSales", bids[i].netSales},
-                    {"fund", bids[i].fund},
-                    {"businessUnit", bids[i].businessUnit}
-                };
-            }
-            return crow::response(response);
-        }
-        catch (const std::exception& e) {
-            return crow::response(500, std::string("Internal server error: ") + e.what());
-        }
-    });
-
-    // Create new bid route
-    CROW_ROUTE(app, "/bids")
-        .methods("POST"_method)
-        .middlewares<TokenVerifier>()
-        ([&dbManager](const crow::request& req) {
-        auto x = crow::json::load(req.body);
-        if (!x) {
-            return crow::response(400, "Invalid JSON");
-        }
-        if (!validateBidInput(x)) {
-            return crow::response(400, "Invalid bid data");
-        }
-        try {
-            Bid bid;
-            // Populate bid object from JSON
-            bid.auctionTitle = x["auctionTitle"].s();
-            bid.auctionId = x["auctionId"].s();
-            bid.department = x["department"].s();
-            bid.closeDate = x["closeDate"].s();
-            bid.winningBid = x["winningBid"].d();
-            bid.ccFee = x["ccFee"].d();
-            bid.feePercent = x["feePercent"].d();
-            bid.auctionFeeSubtotal = x["auctionFeeSubtotal"].d();
-            bid.auctionFeeTotal = x["auctionFeeTotal"].d();
-            bid.payStatus = x["payStatus"].s();
-            bid.paidDate = x["paidDate"].s();
-            bid.assetNumber = x["assetNumber"].s();
-            bid.inventoryId = x["inventoryId"].s();
-            bid.decalVehicleId = x["decalVehicleId"].s();
-            bid.vtrNumber = x["vtrNumber"].s();
-            bid.receiptNumber = x["receiptNumber"].s();
-            bid.cap = x["cap"].d();
-            bid.expenses = x["expenses"].d();
-            bid.netSales = x["netSales"].d();
-            bid.fund = x["fund"].s();
-            bid.businessUnit = x["businessUnit"].s();
-            dbManager.addBid(bid);
-            return crow::response(201, "Bid created successfully");
-        }
-        catch (const std::exception& e) {
-            return crow::response(500, std::string("Internal server error: ") + e.what());
-        }
-    });
-
-    // Get specific bid route
-    CROW_ROUTE(app, "/bids/<string>")
-        .methods("GET"_method)
-        .middlewares<TokenVerifier>()
-        ([&dbManager](const std::string& id) {
-        try {
-            Bid bid = dbManager.getBid(id);
-            crow::json::wvalue response = {
-                {"auctionTitle", bid.auctionTitle},
-                {"auctionId", bid.auctionId},
-                {"department", bid.department},
-                {"closeDate", bid.closeDate},
-                {"winningBid", bid.winningBid},
-                {"ccFee", bid.ccFee},
-                {"feePercent", bid.feePercent},
-                {"auctionFeeSubtotal", bid.auctionFeeSubtotal},
-                {"auctionFeeTotal", bid.auctionFeeTotal},
-                {"payStatus", bid.payStatus},
-                {"paidDate", bid.paidDate},
-                {"assetNumber", bid.assetNumber},
-                {"inventoryId", bid.inventoryId},
-                {"decalVehicleId", bid.decalVehicleId},
-                {"vtrNumber", bid.vtrNumber},
-                {"receiptNumber", bid.receiptNumber},
-                {"cap", bid.cap},
-                {"expenses", bid.expenses},
-                {"netSales", bid.netSales},
-                {"fund", bid.fund},
-                {"businessUnit", bid.businessUnit}
-            };
-            return crow::response(response);
-        }
-        catch (const std::runtime_error& e) {
-            return crow::response(404, "Bid not found");
-        }
-        catch (const std::exception& e) {
-            return crow::response(500, std::string("Internal server error: ") + e.what());
-        }
-    });
-
-    // Update bid route
-    CROW_ROUTE(app, "/bids/<string>")
-        .methods("PUT"_method)
-        .middlewares<TokenVerifier>()
-        ([&dbManager](const crow::request& req, const std::string& id) {
-        auto x = crow::json::load(req.body);
-        if (!x) {
-            return crow::response(400, "Invalid JSON");
-        }
-        if (!validateBidInput(x)) {
-            return crow::response(400, "Invalid bid data");
-        }
-        try {
-            Bid bid;
-            // Populate bid object from JSON
-            bid.auctionTitle = x["auctionTitle"].s();
-            bid.auctionId = id;
-            bid.department = x["department"].s();
-            bid.closeDate = x["closeDate"].s();
-            bid.winningBid = x["winningBid"].d();
-            bid.ccFee = x["ccFee"].d();
-            bid.feePercent = x["feePercent"].d();
-            bid.auctionFeeSubtotal = x["auctionFeeSubtotal"].d();
-            bid.auctionFeeTotal = x["auctionFeeTotal"].d();
-            bid.payStatus = x["payStatus"].s();
-            bid.paidDate = x["paidDate"].s();
-            bid.assetNumber = x["assetNumber"].s();
-            bid.inventoryId = x["inventoryId"].s();
-            bid.decalVehicleId = x["decalVehicleId"].s();
-            bid.vtrNumber = x["vtrNumber"].s();
-            bid.receiptNumber = x["receiptNumber"].s();
-            bid.cap = x["cap"].d();
-            bid.expenses = x["expenses"].d();
-            bid.netSales = x["netSales"].d();
-            bid.fund = x["fund"].s();
-            bid.businessUnit = x["businessUnit"].s();
-            dbManager.updateBid(bid);
-            return crow::response(200, "Bid updated successfully");
-        }
-        catch (const std::runtime_error& e) {
-            return crow::response(404, "Bid not found");
-        }
-        catch (const std::exception& e) {
-            return crow::response(500, std::string("Internal server error: ") + e.what());
-        }
-    });
-
-    // Delete bid route
-    CROW_ROUTE(app, "/bids/<string>")
-        .methods("DELETE"_method)
-        .middlewares<TokenVerifier>()
-        ([&dbManager](const std::string& id) {
-        try {
-            dbManager.deleteBid(id);
-            return crow::response(200, "Bid deleted successfully");
-        }
-        catch (const std::runtime_error& e) {
-            return crow::response(404, "Bid not found");
-        }
-        catch (const std::exception& e) {
-            return crow::response(500, std::string("Internal server error: ") + e.what());
-        }
-    });
-
-    // Enable MFA route
-    CROW_ROUTE(app, "/enable-mfa")
-        .methods("POST"_method)
-        ([&dbManager](const crow::request& req) {
-        auto x = crow::json::load(req.body);
-        if (!x || !x.has("username") || !x.has("password")) {
-            return crow::response(400, "Invalid JSON or missing username/password");
-        }
-
-        try {
-            // Validate user credentials before enabling MFA
-            if (dbManager.validateUser(x["username"].s(), x["password"].s())) {
-                std::string totpSecret = TOTP::generateSecret();
-                dbManager.enableMFA(x["username"].s(), totpSecret);
-                return crow::response(200, totpSecret);
-            }
-            else {
-                return crow::response(401, "Invalid username or password");
-            }
-        }
-        catch (const std::exception& e) {
-            return crow::response(500, std::string("Internal server error: ") + e.what());
-        }
-    });
-
-    // Login route with MFA support
-    CROW_ROUTE(app, "/login")
-        .methods("POST"_method)
-        ([&dbManager](const crow::request& req) {
-        auto x = crow::json::load(req.body);
-        if (!x || !x.has("username") || !x.has("password")) {
-            return crow::response(400, "Invalid JSON or missing username/password");
-        }
-
-        try {
-            if (dbManager.validateUser(x["username"].s(), x["password"].s())) {
-                if (dbManager.isMFAEnabled(x["username"].s())) {
-                    return crow::response(200, "MFA required");
-                }
-                else {
-                    std::string token = createToken(x["username"].s());
-                    return crow::response(200, token);
-                }
-            }
-            else {
-                return crow::response(401, "Invalid username or password");
-            }
-        }
-        catch (const std::exception& e) {
-            return crow::response(500, std::string("Internal server error: ") + e.what());
-        }
-    });
-
-    // Verify MFA route
-    CROW_ROUTE(app, "/verify-mfa")
-        .methods("POST"_method)
-        ([&dbManager](const crow::request& req) {
-        auto x = crow::json::load(req.body);
-        if (!x || !x.has("username") || !x.has("totp")) {
-            return crow::response(400, "Invalid JSON or missing username/totp");
-        }
-
-        try {
-            std::string totpSecret = dbManager.getTOTPSecret(x["username"].s());
-            if (TOTP::verifyTOTP(totpSecret, x["totp"].s())) {
-                std::string token = createToken(x["username"].s());
-                return crow::response(200, token);
-            }
-            else {
-                return crow::response(401, "Invalid TOTP code");
-            }
-        }
-        catch (const std::exception& e) {
-            return crow::response(500, std::string("Internal server error: ") + e.what());
-        }
-    });
-
-    // Start the server
-    app.port(18080).multithreaded().run();
+/*
+ * File: BidManagementServer.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file implements the main server functionality for the Bid Management System.
+ * It sets up the HTTP server, defines API endpoints, and handles user authentication
+ * and bid management operations.
+ *
+ * Dependencies:
+ * - crow framework for HTTP server
+ * - DatabaseManager for data persistence
+ * - JWT for token-based authentication
+ * - BidJson for serializing bid listings
+ * 
+ */
+
+#include "crow.h"
+#include "crow/middleware.h"
+#include "DatabaseManager.h"
+#include "Bid.h"
+#include "User.h"
+#include "Utils.h"
+#include "TOTP.h"
+#include "BidJson.h"
+#include <vector>
+#include <stdexcept>
+#include <cstdlib>
+#include <algorithm>
+#include <jwt-cpp/jwt.h>
+
+
+ // Function to validate the input JSON for a bid
+bool validateBidInput(const crow::json::rvalue& json) {
+
+    // Check if all required fields are present and have the correct types
+    return json.has("auctionTitle") && json.has("auctionId") && json.has("department") &&
+        json.has("closeDate") && json.has("winningBid") && json.has("ccFee") &&
+        json.has("feePercent") && json.has("auctionFeeSubtotal") && json.has("auctionFeeTotal") &&
+        json.has("payStatus") && json.has("paidDate") && json.has("assetNumber") &&
+        json.has("inventoryId") && json.has("decalVehicleId") && json.has("vtrNumber") &&
+        json.has("receiptNumber") && json.has("cap") && json.has("expenses") &&
+        json.has("netSales") && json.has("fund") && json.has("businessUnit") &&
+        json["auctionTitle"].t() == crow::json::type::String &&
+        json["auctionId"].t() == crow::json::type::String &&
+        json["department"].t() == crow::json::type::String &&
+        json["closeDate"].t() == crow::json::type::String &&
+        json["winningBid"].t() == crow::json::type::Number &&
+        json["ccFee"].t() == crow::json::type::Number &&
+        json["feePercent"].t() == crow::json::type::Number &&
+        json["auctionFeeSubtotal"].t() == crow::json::type::Number &&
+        json["auctionFeeTotal"].t() == crow::json::type::Number &&
+        json["payStatus"].t() == crow::json::type::String &&
+        json["paidDate"].t() == crow::json::type::String &&
+        json["assetNumber"].t() == crow::json::type::String &&
+        json["inventoryId"].t() == crow::json::type::String &&
+        json["decalVehicleId"].t() == crow::json::type::String &&
+        json["vtrNumber"].t() == crow::json::type::String &&
+        json["receiptNumber"].t() == crow::json::type::String &&
+        json["cap"].t() == crow::json::type::Number &&
+        json["expenses"].t() == crow::json::type::Number &&
+        json["netSales"].t() == crow::json::type::Number &&
+        json["fund"].t() == crow::json::type::String &&
+        json["businessUnit"].t() == crow::json::type::String;
+}
+
+// Set the dictionary-encoded fields of a bid from validated JSON. Returns false when
+// one of them is a new value and the string pool takes no more from requests.
+bool setInternedFields(const crow::json::rvalue& json, Bid& bid) {
+    return InternedString::TryIntern(std::string(json["department"].s()), bid.department)
+        && InternedString::TryIntern(std::string(json["payStatus"].s()), bid.payStatus)
+        && InternedString::TryIntern(std::string(json["fund"].s()), bid.fund)
+        && InternedString::TryIntern(std::string(json["businessUnit"].s()), bid.businessUnit);
+}
+
+// Function to wrap serialized JSON in a response
+crow::response jsonResponse(std::string body) {
+    crow::response response(std::move(body));
+    response.set_header("Content-Type", "application/json");
+    return response;
+}
+
+// Parse a limit query parameter: defaultLimit when absent, capped at maxLimit.
+// Returns false when it is present but not a positive number.
+bool parseLimit(const char* param, size_t defaultLimit, size_t maxLimit, size_t& limit) {
+    if (!param) {
+        limit = defaultLimit;
+        return true;
+    }
+    // strtoul would also take leading spaces and a minus sign, so check for a digit first
+    char* end = nullptr;
+    unsigned long value = std::strtoul(param, &end, 10);
+    if (*param < '0' || *param > '9' || *end != '\0' || value == 0) {
+        return false;
+    }
+    limit = std::min<size_t>(value, maxLimit);
+    return true;
+}
+
+// Function to create a JWT token for authenticated users
+std::string createToken(const std::string& username) {
+    // Create a JWT token with a 1-hour expiration time
+    auto token = jwt::create()
+        .set_issuer("auth0")
+        .set_type("JWS")
+        .set_payload_claim("username", jwt::claim(username))
+        .set_issued_at(std::chrono::system_clock::now())
+        .set_expires_at(std::chrono::system_clock::now() + std::chrono::hours{ 1 })
+        .sign(jwt::algorithm::hs256{ "secret" });
+    return token;
+}
+
+// Function to verify the JWT token
+bool verifyToken(const std::string& token) {
+    try {
+        // Decode and verify the token
+        auto decoded = jwt::decode(token);
+        auto verifier = jwt::verify()
+            .allow_algorithm(jwt::algorithm::hs256{ "secret" })
+            .with_issuer("auth0");
+        verifier.verify(decoded);
+        return true;
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+}
+
+int main()
+{
+    crow::SimpleApp app;
+
+    // Database file and number of read connections, overridable from the environment
+    const char* databasePath = std::getenv("BIDS_DB_PATH");
+    const char* readConnectionsVariable = std::getenv("BIDS_DB_READ_CONNECTIONS");
+    size_t readConnections = 4;
+    if (readConnectionsVariable) {
+        char* end = nullptr;
+        unsigned long value = std::strtoul(readConnectionsVariable, &end, 10);
+        if (*readConnectionsVariable < '0' || *readConnectionsVariable > '9' || *end != '\0' || value == 0) {
+            std::cerr << "BIDS_DB_READ_CONNECTIONS must be a positive number, not \"" << readConnectionsVariable << "\"" << std::endl;
+            return 1;
+        }
+        readConnections = value;
+    }
+    DatabaseManager dbManager(databasePath ? databasePath : "bids.db", readConnections);
+
+    // Initialize the database
+    try {
+        // Start serving at once; bids are loaded into memory in the background
+        dbManager.init(true);
+
+        // Keep the bid store file current so a restart can skip the full table load
+        dbManager.startStoreWriter(std::chrono::seconds(60));
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Failed to initialize database: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    // Define routes and their handlers
+
+    // Root route
+    CROW_ROUTE(app, "/")([]() {
+        return crow::response("Welcome to the Bid Management System!");
+    });
+
+    // User registration route
+    CROW_ROUTE(app, "/register")
+        .methods("POST"_method)
+        ([&dbManager](const crow::request& req) {
+        auto x = crow::json::load(req.body);
+        if (!x) {
+            return crow::response(400, "Invalid JSON");
+        }
+        if (!x.has("username") || !x.has("password")) {
+            return crow::response(400, "Missing username or password");
+        }
+        try {
+            User user;
+            user.username = x["username"].s();
+            user.passwordHash = hashPassword(x["password"].s());
+            dbManager.addUser(user);
+            return crow::response(201, "User registered successfully");
+        }
+        catch (const std::exception& e) {
+            return crow::response(500, std::string("Internal server error: ") + e.what());
+        }
+    });
+
+
+    // User login route
+    CROW_ROUTE(app, "/login")
+        .methods("POST"_method)
+        ([&dbManager](const crow::request& req) {
+        auto x = crow::json::load(req.body);
+        if (!x) {
+            return crow::response(400, "Invalid JSON");
+        }
+        if (!x.has("username") || !x.has("password")) {
+            return crow::response(400, "Missing username or password");
+        }
+        try {
+            if (dbManager.validateUser(x["username"].s(), x["password"].s())) {
+                std::string token = createToken(x["username"].s());
+                std::cout << "Generated token: " << token << std::endl;  // Log the generated token
+                return crow::response(200, token);
+            }
+            else {
+                return crow::response(401, "Invalid username or password");
+            }
+        }
+        catch (const std::exception& e) {
+            return crow::response(500, std::string("Internal server error: ") + e.what());
+        }
+    });
+
+    // Middleware for token verification
+    struct TokenVerifier {
+        bool before(crow::request& req) {
+            std::cout << "TokenVerifier: Checking authorization" << std::endl;
+            auto auth_header = req.get_header_value("Authorization");
+            std::cout << "TokenVerifier: Auth header: " << auth_header << std::endl;
+
+            if (auth_header.empty() || auth_header.substr(0, 7) != "Bearer ") {
+                std::cout << "TokenVerifier: Invalid Authorization header format" << std::endl;
+                return false;
+            }
+
+            std::string token = auth_header.substr(7);
+            std::cout << "TokenVerifier: Extracted token: " << token << std::endl;
+
+            bool is_valid = verifyToken(token);
+            std::cout << "TokenVerifier: Token validity: " << (is_valid ? "valid" : "invalid") << std::endl;
+
+            return is_valid;
+        }
+    };
+
+    // CSV import route
+    CROW_ROUTE(app, "/import-csv")
+        .methods("POST"_method)
+        .middlewares<TokenVerifier>()
+        ([&dbManager](const crow::request& req) {
+        auto x = crow::json::load(req.body);
+        if (!x || !x.has("filename")) {
+            return crow::response(400, "Invalid JSON or missing filename");
+        }
+
+        size_t batchSize = 1000;
+        if (x.has("batchSize") && x["batchSize"].t() == crow::json::type::Number && x["batchSize"].i() > 0) {
+            batchSize = static_cast<size_t>(x["batchSize"].i());
+        }
+
+        try {
+            ImportSummary summary = dbManager.importFromCSV(x["filename"].s(), batchSize);
+            crow::json::wvalue response = {
+                {"rows", summary.rows},
+                {"imported", summary.imported},
+                {"rejected", summary.rejected},
+                {"seconds", summary.seconds},
+                {"rowsPerSecond", summary.rowsPerSecond}
+            };
+            return crow::response(200, response);
+        }
+        catch (const std::exception& e) {
+            return crow::response(500, std::string("Error importing CSV: ") + e.what());
+        }
+    });
+
+    // Get all bids route. With filters, limit, cursor or sort it returns one page of a
+    // query instead, e.g. /bids?department=ITS&minWinningBid=100&sort=-closeDate&limit=50,
+    // then the same query with cursor=<next from the previous page>
+    CROW_ROUTE(app, "/bids")
+        .methods("GET"_method)
+        .middlewares<TokenVerifier>()
+        ([&dbManager](const crow::request& req) {
+        const char* limitParam = req.url_params.get("limit");
+        const char* cursorParam = req.url_params.get("cursor");
+        const char* sortParam = req.url_params.get("sort");
+
+        try {
+            // Every other parameter is a filter, e.g. department=ITS or minWinningBid=100
+            BidQuery query;
+            for (const std::string& name : req.url_params.keys()) {
+                if (name == "limit" || name == "cursor" || name == "sort") {
+                    continue;
+                }
+                if (!query.AddFilter(name, req.url_params.get(name))) {
+                    return crow::response(400, "Unknown query parameter: " + name);
+                }
+            }
+            if (sortParam) {
+                query.SetSort(sortParam);
+            }
+
+            if (!limitParam && !cursorParam && !sortParam && !query.HasFilters()) {
+                // Serialize straight into the response body, sized up front; Crow sends
+                // bodies above its stream threshold in pieces rather than copying them
+                BidView bids = dbManager.getAllBids();
+                std::string body;
+                body.reserve(BidJson::EstimateSize(bids));
+                BidJson::AppendArray(body, bids);
+                return jsonResponse(std::move(body));
+            }
+
+            size_t limit;
+            if (!parseLimit(limitParam, 100, 1000, limit)) {
+                return crow::response(400, "Invalid limit");
+            }
+
+            BidPage page = dbManager.getBidPage(query, cursorParam ? cursorParam : "", limit);
+            std::string body;
+            body.reserve(BidJson::EstimateSize(page.bids) + page.nextCursor.size() + 32);
+            body += "{\"bids\":";
+            BidJson::AppendArray(body, page.bids);
+            body += ",\"next\":";
+            if (page.nextCursor.empty()) {
+                body += "null";
+            }
+            else {
+                BidJson::AppendString(body, page.nextCursor);
+            }
+            body += "}";
+            return jsonResponse(std::move(body));
+        }
+        catch (const std::invalid_argument& e) {
+            return crow::response(400, e.what());
+        }
+        catch (const std::exception& e) {
+            return crow::response(500, std::string("Internal server error: ") + e.what());
+        }
+    });
+
+    // Keyword search over auction titles, e.g. /search/bids?q=dell+lap&limit=20. Every
+    // word must match, the last one as a prefix; results are ranked by relevance. Kept
+    // outside /bids/ so that it cannot shadow a bid whose auction ID is "search".
+    CROW_ROUTE(app, "/search/bids")
+        .methods("GET"_method)
+        .middlewares<TokenVerifier>()
+        ([&dbManager](const crow::request& req) {
+        const char* queryParam = req.url_params.get("q");
+        const char* limitParam = req.url_params.get("limit");
+        if (!queryParam) {
+            return crow::response(400, "Missing q");
+        }
+
+        size_t limit;
+        if (!parseLimit(limitParam, 50, 1000, limit)) {
+            return crow::response(400, "Invalid limit");
+        }
+
+        try {
+            BidView bids = dbManager.searchBids(queryParam, limit);
+            std::string body;
+            body.reserve(BidJson::EstimateSize(bids));
+            BidJson::AppendArray(body, bids);
+            return jsonResponse(std::move(body));
+        }
+        catch (const std::exception& e) {
+            return crow::response(500, std::string("Internal server error: ") + e.what());
+        }
+    });
+
+    // Autocomplete over an identifier, e.g. /suggest/bids?field=assetNumber&prefix=07&limit=10.
+    // Fields: auctionId, assetNumber, receiptNumber, vtrNumber. Values come back in order.
+    CROW_ROUTE(app, "/suggest/bids")
+        .methods("GET"_method)
+        .middlewares<TokenVerifier>()
+        ([&dbManager](const crow::request& req) {
+        const char* fieldParam = req.url_params.get("field");
+        const char* prefixParam = req.url_params.get("prefix");
+        const char* limitParam = req.url_params.get("limit");
+        if (!fieldParam || !prefixParam) {
+            return crow::response(400, "Missing field or prefix");
+        }
+
+        BidColumnStore::IdentifierColumn column;
+        if (!BidColumnStore::ParseIdentifierColumn(fieldParam, column)) {
+            return crow::response(400, "Invalid field");
+        }
+
+        size_t limit;
+        if (!parseLimit(limitParam, 10, 100, limit)) {
+            return crow::response(400, "Invalid limit");
+        }
+
+        try {
+            std::vector<PrefixIndex::Completion> completions = dbManager.getCompletions(column, prefixParam, limit);
+            std::string body = "[";
+            for (size_t i = 0; i < completions.size(); i++) {
+                body += (i == 0) ? "{\"value\":" : ",{\"value\":";
+                BidJson::AppendString(body, completions[i].value);
+                body += ",\"auctionId\":";
+                BidJson::AppendString(body, completions[i].auctionId);
+                body += '}';
+            }
+            body += ']';
+            return jsonResponse(std::move(body));
+        }
+        catch (const std::exception& e) {
+            return crow::response(500, std::string("Internal server error: ") + e.what());
+        }
+    });
+
+    // Reverse lookup of an inventory item, e.g. /inventory/75144. Returns the bids whose
+    // inventoryId list contains it, usually one.
+    CROW_ROUTE(app, "/inventory/<string>")
+        .methods("GET"_method)
+        .middlewares<TokenVerifier>()
+        ([&dbManager](const std::string& item) {
+        try {
+            BidView bids = dbManager.getBidsByInventoryId(item);
+            if (bids.size() == 0) {
+                return crow::response(404, "Inventory item not found");
+            }
+            std::string body;
+            body.reserve(BidJson::EstimateSize(bids));
+            BidJson::AppendArray(body, bids);
+            return jsonResponse(std::move(body));
+        }
+        catch (const std::exception& e) {
+            return crow::response(500, std::string("Internal server error: ") + e.what());
+        }
+    });
+
+    // Aggregate report route, e.g. /reports/totals?groupBy=department&column=netSales
+    CROW_ROUTE(app, "/reports/totals")
+        .methods("GET"_method)
+        .middlewares<TokenVerifier>()
+        ([&dbManager](const crow::request& req) {
+        const char* groupBy = req.url_params.get("groupBy");
+        const char* column = req.url_params.get("column");
+
+        BidColumnStore::GroupColumn group = BidColumnStore::Department;
+        BidColumnStore::NumericColumn numeric = BidColumnStore::NetSales;
+        if ((groupBy && !BidColumnStore::ParseGroupColumn(groupBy, group)) ||
+            (column && !BidColumnStore::ParseNumericColumn(column, numeric))) {
+            return crow::response(400, "Invalid groupBy or column");
+        }
+
+        try {
+            std::vector<std::pair<std::string, double>> totals = dbManager.getColumnTotals(group, numeric);
+            crow::json::wvalue response;
+            for (size_t i = 0; i < totals.size(); i++) {
+                response[i] = {
+                    {"value", totals[i].first},
+                    {"total", totals[i].second}
+                };
+            }
+            return crow::response(response);
+        }
+        catch (const std::exception& e) {
+            return crow::response(500, std::string("Internal server error: ") + e.what());
+        }
+    });
+
+    // Prepared statement timing route, used to check the effect of statement caching
+    CROW_ROUTE(app, "/stats/statements")
+        .methods("GET"_method)
+        .middlewares<TokenVerifier>()
+        ([&dbManager]() {
+        std::vector<StatementCache::Timing> timings = dbManager.getStatementTimings();
+        crow::json::wvalue response;
+        for (size_t i = 0; i < timings.size(); i++) {
+            response[i] = {
+                {"statement", timings[i].name},
+                {"prepareNanos", timings[i].prepareNanos},
+                {"executions", timings[i].executions},
+                {"steps", timings[i].steps},
+                {"stepNanos", timings[i].stepNanos}
+            };
+        }
+        return crow::response(response);
+    });
+
+    // Warm-up progress route; until ready, bid reads are served from the database
+    CROW_ROUTE(app, "/stats/warmup")
+        .methods("GET"_method)
+        .middlewares<TokenVerifier>()
+        ([&dbManager]() {
+        WarmupProgress progress = dbManager.getWarmupProgress();
+        crow::json::wvalue response;
+        response["ready"] = progress.ready;
+        response["loaded"] = progress.loaded;
+        response["total"] = progress.total;
+        response["seconds"] = progress.seconds;
+        return crow::response(response);
+    });
+
+    // Create new bid route
+    CROW_ROUTE(app, "/bids")
+        .methods("POST"_method)
+        .middlewares<TokenVerifier>()
+        ([&dbManager](const crow::request& req) {
+        auto x = crow::json::load(req.body);
+        if (!x) {
+            return crow::response(400, "Invalid JSON");
+        }
+        if (!validateBidInput(x)) {
+            return crow::response(400, "Invalid bid data");
+        }
+        try {
+            Bid bid;
+            // Populate bid object from JSON
+            bid.auctionTitle = x["auctionTitle"].s();
+            bid.auctionId = x["auctionId"].s();
+            bid.closeDate = x["closeDate"].s();
+            bid.winningBid = x["winningBid"].d();
+            bid.ccFee = x["ccFee"].d();
+            bid.feePercent = x["feePercent"].d();
+            bid.auctionFeeSubtotal = x["auctionFeeSubtotal"].d();
+            bid.auctionFeeTotal = x["auctionFeeTotal"].d();
+            bid.paidDate = x["paidDate"].s();
+            bid.assetNumber = x["assetNumber"].s();
+            bid.inventoryId = x["inventoryId"].s();
+            bid.decalVehicleId = x["decalVehicleId"].s();
+            bid.vtrNumber = x["vtrNumber"].s();
+            bid.receiptNumber = x["receiptNumber"].s();
+            bid.cap = x["cap"].d();
+            bid.expenses = x["expenses"].d();
+            bid.netSales = x["netSales"].d();
+            if (!setInternedFields(x, bid)) {
+                return crow::response(400, "Too many distinct department, pay status, fund or business unit values");
+            }
+            dbManager.addBid(bid);
+            return crow::response(201, "Bid created successfully");
+        }
+        catch (const std::exception& e) {
+            return crow::response(500, std::string("Internal server error: ") + e.what());
+        }
+    });
+
+    // Get specific bid route
+    CROW_ROUTE(app, "/bids/<string>")
+        .methods("GET"_method)
+        .middlewares<TokenVerifier>()
+        ([&dbManager](const std::string& id) {
+        try {
+            Bid bid = dbManager.getBid(id);
+            crow::json::wvalue response = {
+                {"auctionTitle", bid.auctionTitle},
+                {"auctionId", bid.auctionId},
+                {"department", bid.department.str()},
+                {"closeDate", bid.closeDate},
+                {"winningBid", bid.winningBid},
+                {"ccFee", bid.ccFee},
+                {"feePercent", bid.feePercent},
+                {"auctionFeeSubtotal", bid.auctionFeeSubtotal},
+                {"auctionFeeTotal", bid.auctionFeeTotal},
+                {"payStatus", bid.payStatus.str()},
+                {"paidDate", bid.paidDate},
+                {"assetNumber", bid.assetNumber},
+                {"inventoryId", bid.inventoryId},
+                {"decalVehicleId", bid.decalVehicleId},
+                {"vtrNumber", bid.vtrNumber},
+                {"receiptNumber", bid.receiptNumber},
+                {"cap", bid.cap},
+                {"expenses", bid.expenses},
+                {"netSales", bid.netSales},
+                {"fund", bid.fund.str()},
+                {"businessUnit", bid.businessUnit.str()}
+            };
+            return crow::response(response);
+        }
+        catch (const std::runtime_error& e) {
+            return crow::response(404, "Bid not found");
+        }
+        catch (const std::exception& e) {
+            return crow::response(500, std::string("Internal server error: ") + e.what());
+        }
+    });
+
+    // Update bid route
+    CROW_ROUTE(app, "/bids/<string>")
+        .methods("PUT"_method)
+        .middlewares<TokenVerifier>()
+        ([&dbManager](const crow::request& req, const std::string& id) {
+        auto x = crow::json::load(req.body);
+        if (!x) {
+            return crow::response(400, "Invalid JSON");
+        }
+        if (!validateBidInput(x)) {
+            return crow::response(400, "Invalid bid data");
+        }
+        try {
+            Bid bid;
+            // Populate bid object from JSON
+            bid.auctionTitle = x["auctionTitle"].s();
+            bid.auctionId = id;
+            bid.closeDate = x["closeDate"].s();
+            bid.winningBid = x["winningBid"].d();
+            bid.ccFee = x["ccFee"].d();
+            bid.feePercent = x["feePercent"].d();
+            bid.auctionFeeSubtotal = x["auctionFeeSubtotal"].d();
+            bid.auctionFeeTotal = x["auctionFeeTotal"].d();
+            bid.paidDate = x["paidDate"].s();
+            bid.assetNumber = x["assetNumber"].s();
+            bid.inventoryId = x["inventoryId"].s();
+            bid.decalVehicleId = x["decalVehicleId"].s();
+            bid.vtrNumber = x["vtrNumber"].s();
+            bid.receiptNumber = x["receiptNumber"].s();
+            bid.cap = x["cap"].d();
+            bid.expenses = x["expenses"].d();
+            bid.netSales = x["netSales"].d();
+            if (!setInternedFields(x, bid)) {
+                return crow::response(400, "Too many distinct department, pay status, fund or business unit values");
+            }
+            dbManager.updateBid(bid);
+            return crow::response(200, "Bid updated successfully");
+        }
+        catch (const std::runtime_error& e) {
+            return crow::response(404, "Bid not found");
+        }
+        catch (const std::exception& e) {
+            return crow::response(500, std::string("Internal server error: ") + e.what());
+        }
+    });
+
+    // Delete bid route
+    CROW_ROUTE(app, "/bids/<string>")
+        .methods("DELETE"_method)
+        .middlewares<TokenVerifier>()
+        ([&dbManager](const std::string& id) {
+        try {
+            dbManager.deleteBid(id);
+            return crow::response(200, "Bid deleted successfully");
+        }
+        catch (const std::runtime_error& e) {
+            return crow::response(404, "Bid not found");
+        }
+        catch (const std::exception& e) {
+            return crow::response(500, std::string("Internal server error: ") + e.what());
+        }
+    });
+
+    // Enable MFA route
+    CROW_ROUTE(app, "/enable-mfa")
+        .methods("POST"_method)
+        ([&dbManager](const crow::request& req) {
+        auto x = crow::json::load(req.body);
+        if (!x || !x.has("username") || !x.has("password")) {
+            return crow::response(400, "Invalid JSON or missing username/password");
+        }
+
+        try {
+            // Validate user credentials before enabling MFA
+            if (dbManager.validateUser(x["username"].s(), x["password"].s())) {
+                std::string totpSecret = TOTP::generateSecret();
+                dbManager.enableMFA(x["username"].s(), totpSecret);
+                return crow::response(200, totpSecret);
+            }
+            else {
+                return crow::response(401, "Invalid username or password");
+            }
+        }
+        catch (const std::exception& e) {
+            return crow::response(500, std::string("Internal server error: ") + e.what());
+        }
+    });
+
+    // Login route with MFA support
+    CROW_ROUTE(app, "/login")
+        .methods("POST"_method)
+        ([&dbManager](const crow::request& req) {
+        auto x = crow::json::load(req.body);
+        if (!x || !x.has("username") || !x.has("password")) {
+            return crow::response(400, "Invalid JSON or missing username/password");
+        }
+
+        try {
+            if (dbManager.validateUser(x["username"].s(), x["password"].s())) {
+                if (dbManager.isMFAEnabled(x["username"].s())) {
+                    return crow::response(200, "MFA required");
+                }
+                else {
+                    std::string token = createToken(x["username"].s());
+                    return crow::response(200, token);
+                }
+            }
+            else {
+                return crow::response(401, "Invalid username or password");
+            }
+        }
+        catch (const std::exception& e) {
+            return crow::response(500, std::string("Internal server error: ") + e.what());
+        }
+    });
+
+    // Verify MFA route
+    CROW_ROUTE(app, "/verify-mfa")
+        .methods("POST"_method)
+        ([&dbManager](const crow::request& req) {
+        auto x = crow::json::load(req.body);
+        if (!x || !x.has("username") || !x.has("totp")) {
+            return crow::response(400, "Invalid JSON or missing username/totp");
+        }
+
+        try {
+            std::string totpSecret = dbManager.getTOTPSecret(x["username"].s());
+            if (TOTP::verifyTOTP(totpSecret, x["totp"].s())) {
+                std::string token = createToken(x["username"].s());
+                return crow::response(200, token);
+            }
+            else {
+                return crow::response(401, "Invalid TOTP code");
+            }
+        }
+        catch (const std::exception& e) {
+            return crow::response(500, std::string("Internal server error: ") + e.what());
+        }
+    });
+
+    // Start the server
+    app.port(18080).multithreaded().run();
 }
\ No newline at end of file
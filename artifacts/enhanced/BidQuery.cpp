@@ -0,0 +1,340 @@
+/*
+ * File: BidQuery.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file implements the BidQuery class: parsing of filter and sort parameters,
+ * the planner that picks an access path, and query execution over a snapshot.
+ *
+ * Dependencies:
+ * - BidQuery.h
+ * - NumberParsing.h for numeric bounds
+ *
+ */
+
+#include "BidQuery.h"
+#include "NumberParsing.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+BidQuery::BidQuery() : descending(false) {
+    sortColumn.kind = Column::AuctionId;
+    sortColumn.index = 0;
+}
+
+// Add a filter from a query string parameter
+bool BidQuery::AddFilter(const std::string& name, const std::string& value) {
+    BidColumnStore::GroupColumn group;
+    if (BidColumnStore::ParseGroupColumn(name, group)) {
+        // Find never adds to the string pool, so unknown values cost nothing and match nothing
+        Equals filter;
+        filter.column = group;
+        filter.code = InternedString::Find(value);
+        equals.push_back(filter);
+        return true;
+    }
+
+    // Bounds are named min<Column> or max<Column>, e.g. minWinningBid
+    bool isMin = (name.compare(0, 3, "min") == 0);
+    bool isMax = (name.compare(0, 3, "max") == 0);
+    if ((!isMin && !isMax) || name.size() < 4) {
+        return false;
+    }
+    std::string columnName = name.substr(3);
+    columnName[0] = static_cast<char>(std::tolower(static_cast<unsigned char>(columnName[0])));
+
+    Column column;
+    if (!parseColumn(columnName, column) || column.kind == Column::AuctionId) {
+        return false;
+    }
+
+    double bound = 0;
+    if (column.kind == Column::Date) {
+        bound = BidColumnStore::ParseDate(value);
+        if (bound == 0) {
+            throw std::invalid_argument("Invalid date for " + name + ": expected MM/DD/YYYY");
+        }
+    }
+    else {
+        ParseStatus status = (column.index == BidColumnStore::FeePercent) ? parsePercent(value, bound) : parseMoney(value, bound);
+        if (value.empty() || status != ParseStatus::Ok || !std::isfinite(bound)) {
+            throw std::invalid_argument("Invalid number for " + name);
+        }
+    }
+
+    // Both bounds on one column form a single range
+    Range* range = nullptr;
+    for (Range& existing : ranges) {
+        if (existing.column.kind == column.kind && existing.column.index == column.index) {
+            range = &existing;
+        }
+    }
+    if (range == nullptr) {
+        Range added;
+        added.column = column;
+        // A date range never matches bids without that date, which have the value 0
+        added.min = (column.kind == Column::Date) ? 1 : -std::numeric_limits<double>::infinity();
+        added.max = std::numeric_limits<double>::infinity();
+        ranges.push_back(added);
+        range = &ranges.back();
+    }
+    if (isMin) {
+        range->min = std::max(range->min, bound);
+    }
+    else {
+        range->max = std::min(range->max, bound);
+    }
+    return true;
+}
+
+// Sort by a column, descending with a leading '-'
+void BidQuery::SetSort(const std::string& spec) {
+    bool isDescending = (!spec.empty() && spec[0] == '-');
+    std::string name = isDescending ? spec.substr(1) : spec;
+
+    Column column;
+    if (!parseColumn(name, column)) {
+        throw std::invalid_argument("Unknown sort column: " + name);
+    }
+    sortColumn = column;
+    descending = isDescending;
+}
+
+bool BidQuery::HasFilters() const {
+    return !equals.empty() || !ranges.empty();
+}
+
+// True when the sort key is the auction ID alone
+bool BidQuery::SortsById() const {
+    return sortColumn.kind == Column::AuctionId;
+}
+
+bool BidQuery::SortsDescending() const {
+    return descending;
+}
+
+// Key of a bid in this query's sort order
+BidQuery::Key BidQuery::KeyOf(const Bid& bid) const {
+    Key key;
+    key.value = SortsById() ? 0 : valueOf(bid, sortColumn);
+    key.auctionId = bid.auctionId;
+    return key;
+}
+
+// Row numbers of up to limit matching bids in sort order, starting after a key
+std::vector<uint32_t> BidQuery::Execute(const BidSnapshot& snapshot, const Key* after, size_t limit) const {
+    std::vector<uint32_t> result;
+    if (limit == 0 || snapshot.size() == 0) {
+        return result;
+    }
+
+    // Access path with the fewest candidate rows: every row in snapshot order, the rows
+    // with one code, or the slice of a column's order that lies within a range
+    const std::vector<uint32_t>* path = nullptr;
+    size_t first = 0;
+    size_t last = snapshot.size();
+    for (const Equals& filter : equals) {
+        const std::vector<uint32_t>& rows = snapshot.RowsWithCode(filter.column, filter.code);
+        if (rows.size() < last - first) {
+            path = &rows;
+            first = 0;
+            last = rows.size();
+        }
+    }
+
+    // The slice of the sort column's order that can hold matches
+    const std::vector<uint32_t>& sortOrder = orderOf(snapshot, sortColumn);
+    size_t sortFirst = 0;
+    size_t sortLast = sortOrder.size();
+
+    for (const Range& filter : ranges) {
+        const std::vector<uint32_t>& order = orderOf(snapshot, filter.column);
+        auto low = std::partition_point(order.begin(), order.end(), [&](uint32_t row) {
+            return valueOf(snapshot[row], filter.column) < filter.min;
+        });
+        auto high = std::partition_point(low, order.end(), [&](uint32_t row) {
+            return valueOf(snapshot[row], filter.column) <= filter.max;
+        });
+        size_t rangeFirst = static_cast<size_t>(low - order.begin());
+        size_t rangeLast = static_cast<size_t>(high - order.begin());
+
+        if (&order == &sortOrder) {
+            sortFirst = rangeFirst;
+            sortLast = rangeLast;
+        }
+        if (rangeLast - rangeFirst < last - first) {
+            path = &order;
+            first = rangeFirst;
+            last = rangeLast;
+        }
+    }
+
+    size_t candidates = last - first;
+    if (candidates == 0) {
+        return result;
+    }
+
+    // Estimated rows touched by each plan. Reading the access path means filtering
+    // every candidate and sorting what matches. Walking the sort order reads rows in
+    // result order and stops once limit rows match; assuming matches are spread
+    // evenly, that is the fraction of the slice the page represents.
+    double sortSlice = static_cast<double>(sortLast - sortFirst);
+    double estimatedMatches = std::max(1.0, std::min(static_cast<double>(candidates), sortSlice));
+    double walkCost = std::min(sortSlice, static_cast<double>(limit) * sortSlice / estimatedMatches);
+    double pathCost = candidates * (1.0 + std::log2(static_cast<double>(candidates) + 1.0));
+    bool pathIsSortOrder = (path == &sortOrder);
+
+    if (pathIsSortOrder || walkCost <= pathCost) {
+        // Walk the sort order in result direction, checking every filter on the way
+        if (!descending) {
+            size_t position = sortFirst;
+            if (after != nullptr) {
+                auto start = std::partition_point(sortOrder.begin() + sortFirst, sortOrder.begin() + sortLast, [&](uint32_t row) {
+                    return compare(snapshot[row], *after) <= 0;
+                });
+                position = static_cast<size_t>(start - sortOrder.begin());
+            }
+            for (; position < sortLast && result.size() < limit; position++) {
+                if (matches(snapshot[sortOrder[position]])) {
+                    result.push_back(sortOrder[position]);
+                }
+            }
+        }
+        else {
+            size_t position = sortLast;
+            if (after != nullptr) {
+                auto start = std::partition_point(sortOrder.begin() + sortFirst, sortOrder.begin() + sortLast, [&](uint32_t row) {
+                    return compare(snapshot[row], *after) < 0;
+                });
+                position = static_cast<size_t>(start - sortOrder.begin());
+            }
+            for (; position > sortFirst && result.size() < limit; position--) {
+                if (matches(snapshot[sortOrder[position - 1]])) {
+                    result.push_back(sortOrder[position - 1]);
+                }
+            }
+        }
+        return result;
+    }
+
+    // Read the access path, checking the remaining filters in the same pass
+    std::vector<uint32_t> rows;
+    for (size_t i = first; i < last; i++) {
+        uint32_t row = (path != nullptr) ? (*path)[i] : static_cast<uint32_t>(i);
+        if (matches(snapshot[row])) {
+            rows.push_back(row);
+        }
+    }
+
+    // Sort the matches (the path is never the sort order here, or it would have been walked)
+    if (SortsById()) {
+        std::sort(rows.begin(), rows.end(), [&snapshot](uint32_t a, uint32_t b) {
+            return snapshot[a].auctionId < snapshot[b].auctionId;
+        });
+    }
+    else {
+        // Compute each sort value once; dates would otherwise be parsed on every comparison
+        std::vector<std::pair<double, uint32_t>> keyed;
+        keyed.reserve(rows.size());
+        for (uint32_t row : rows) {
+            keyed.emplace_back(valueOf(snapshot[row], sortColumn), row);
+        }
+        std::sort(keyed.begin(), keyed.end(), [&snapshot](const std::pair<double, uint32_t>& a, const std::pair<double, uint32_t>& b) {
+            if (a.first != b.first) {
+                return a.first < b.first;
+            }
+            return snapshot[a.second].auctionId < snapshot[b.second].auctionId;
+        });
+        for (size_t i = 0; i < keyed.size(); i++) {
+            rows[i] = keyed[i].second;
+        }
+    }
+    if (descending) {
+        std::reverse(rows.begin(), rows.end());
+    }
+
+    // Skip to the first row after the key, then take the page
+    auto start = rows.begin();
+    if (after != nullptr) {
+        start = std::partition_point(rows.begin(), rows.end(), [&](uint32_t row) {
+            int order = compare(snapshot[row], *after);
+            return descending ? order >= 0 : order <= 0;
+        });
+    }
+    size_t count = std::min(limit, static_cast<size_t>(rows.end() - start));
+    result.assign(start, start + count);
+    return result;
+}
+
+// Map a column name to a sortable column
+bool BidQuery::parseColumn(const std::string& name, Column& column) {
+    BidColumnStore::NumericColumn numeric;
+    BidColumnStore::DateColumn date;
+    if (name == "auctionId") {
+        column.kind = Column::AuctionId;
+        column.index = 0;
+    }
+    else if (BidColumnStore::ParseNumericColumn(name, numeric)) {
+        column.kind = Column::Numeric;
+        column.index = numeric;
+    }
+    else if (BidColumnStore::ParseDateColumn(name, date)) {
+        column.kind = Column::Date;
+        column.index = date;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+// Value of a numeric or date column for one bid
+double BidQuery::valueOf(const Bid& bid, const Column& column) {
+    if (column.kind == Column::Date) {
+        return BidColumnStore::DateValue(bid, static_cast<BidColumnStore::DateColumn>(column.index));
+    }
+    return BidColumnStore::NumericValue(bid, static_cast<BidColumnStore::NumericColumn>(column.index));
+}
+
+// Snapshot rows in ascending order of a column
+const std::vector<uint32_t>& BidQuery::orderOf(const BidSnapshot& snapshot, const Column& column) {
+    switch (column.kind) {
+    case Column::Numeric: return snapshot.OrderBy(static_cast<BidColumnStore::NumericColumn>(column.index));
+    case Column::Date: return snapshot.OrderByDate(static_cast<BidColumnStore::DateColumn>(column.index));
+    default: return snapshot.OrderById();
+    }
+}
+
+// Order a bid against a key in ascending column order
+int BidQuery::compare(const Bid& bid, const Key& key) const {
+    if (!SortsById()) {
+        double value = valueOf(bid, sortColumn);
+        if (value != key.value) {
+            return (value < key.value) ? -1 : 1;
+        }
+    }
+    return bid.auctionId.compare(key.auctionId);
+}
+
+// Whether a bid passes every filter
+bool BidQuery::matches(const Bid& bid) const {
+    for (const Equals& filter : equals) {
+        if (BidColumnStore::GroupCode(bid, filter.column) != filter.code) {
+            return false;
+        }
+    }
+    for (const Range& filter : ranges) {
+        double value = valueOf(bid, filter.column);
+        if (value < filter.min || value > filter.max) {
+            return false;
+        }
+    }
+    return true;
+}
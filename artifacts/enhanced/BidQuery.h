@@ -0,0 +1,114 @@
+/*
+ * File: BidQuery.h
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file defines the BidQuery class, a server-side filter and sort over a bid
+ * snapshot, built from query string parameters such as
+ * department=ITS&payStatus=Successful&minWinningBid=100&sort=-closeDate.
+ *
+ * A small planner picks how to run each query. The snapshot's indexes are the access
+ * paths: a row list per code of each interned column for equality filters, and the
+ * sorted orders of the numeric and date columns for range filters. The path with the
+ * fewest candidate rows is read and the other filters are checked in the same pass.
+ * When the result would be sorted by a column whose order is already known, the
+ * planner may instead walk that order and stop as soon as the page is full, which is
+ * cheaper for broad filters.
+ *
+ * Dependencies:
+ * - Bid.h for the Bid structure
+ * - BidSnapshot.h for the snapshot and its indexes
+ * - BidColumnStore.h for the column names and values
+ *
+ */
+
+#pragma once
+#include "Bid.h"
+#include "BidSnapshot.h"
+#include "BidColumnStore.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class BidQuery {
+public:
+    // Position of a bid in the query's sort order; the value is unused when sorting by auction ID
+    struct Key {
+        double value;
+        std::string auctionId;
+
+        Key() : value(0) {}
+    };
+
+    // Every bid, ordered by auction ID
+    BidQuery();
+
+    // Add a filter from a query string parameter: an interned column compared for
+    // equality (department=ITS), or an inclusive bound on a numeric or date column
+    // (minWinningBid=100, maxCloseDate=12/31/2013). Returns false if the name is not a
+    // filter; throws std::invalid_argument for a malformed value.
+    bool AddFilter(const std::string& name, const std::string& value);
+
+    // Sort by auctionId or a numeric or date column, descending with a leading '-'
+    // (e.g. "-closeDate"). Ties are broken by auction ID in the same direction.
+    // Throws std::invalid_argument for an unknown column.
+    void SetSort(const std::string& spec);
+
+    bool HasFilters() const;
+
+    // True when the sort key is the auction ID alone
+    bool SortsById() const;
+
+    bool SortsDescending() const;
+
+    // Key of a bid in this query's sort order
+    Key KeyOf(const Bid& bid) const;
+
+    // Row numbers of up to limit matching bids of a snapshot in sort order, starting
+    // after the given key when after is not null
+    std::vector<uint32_t> Execute(const BidSnapshot& snapshot, const Key* after = nullptr, size_t limit = SIZE_MAX) const;
+
+private:
+    // A column the query can sort or range-filter by
+    struct Column {
+        enum Kind { AuctionId, Numeric, Date } kind;
+        int index;  // NumericColumn or DateColumn
+    };
+
+    // Equality filter on an interned column
+    struct Equals {
+        BidColumnStore::GroupColumn column;
+        uint32_t code;  // InternedString::NotFound when the value never occurs
+    };
+
+    // Inclusive range filter on a numeric or date column
+    struct Range {
+        Column column;
+        double min;
+        double max;
+    };
+
+    std::vector<Equals> equals;
+    std::vector<Range> ranges;
+    Column sortColumn;
+    bool descending;
+
+    // Map a column name to a sortable column
+    static bool parseColumn(const std::string& name, Column& column);
+
+    // Value of a numeric or date column for one bid
+    static double valueOf(const Bid& bid, const Column& column);
+
+    // Snapshot rows in ascending order of a column, ties broken by auction ID
+    static const std::vector<uint32_t>& orderOf(const BidSnapshot& snapshot, const Column& column);
+
+    // Order a bid against a key in ascending column order: negative, zero or positive
+    int compare(const Bid& bid, const Key& key) const;
+
+    // Whether a bid passes every filter
+    bool matches(const Bid& bid) const;
+};
@@ -0,0 +1,138 @@
+/*
+ * File: BidSnapshot.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file implements the non-template parts of the BidSnapshot and BidView
+ * classes, the immutable views used to hand out sorted and filtered bid listings.
+ *
+ * Dependencies:
+ * - BidSnapshot.h
+ *
+ */
+
+#include "BidSnapshot.h"
+#include <utility>
+
+BidSnapshot::BidSnapshot(std::vector<BidPtr> aRows) : rows(std::move(aRows)) {}
+
+BidSnapshot::BidSnapshot(std::vector<BidPtr> aRows, std::vector<uint32_t> anOrderById) : rows(std::move(aRows)) {
+    std::call_once(sortedByIdOnce, [this, &anOrderById]() {
+        sortedById = std::move(anOrderById);
+    });
+}
+
+size_t BidSnapshot::size() const {
+    return rows.size();
+}
+
+const Bid& BidSnapshot::operator[](size_t row) const {
+    return *rows[row];
+}
+
+const BidPtr& BidSnapshot::Get(size_t row) const {
+    return rows[row];
+}
+
+// Row numbers ordered by auction ID
+const std::vector<uint32_t>& BidSnapshot::OrderById() const {
+    std::call_once(sortedByIdOnce, [this]() {
+        sortedById = SortedOrder([](const Bid& a, const Bid& b) { return a.auctionId < b.auctionId; });
+    });
+    return sortedById;
+}
+
+// Row numbers ordered by a numeric column, ties broken by auction ID
+const std::vector<uint32_t>& BidSnapshot::OrderBy(BidColumnStore::NumericColumn column) const {
+    std::call_once(sortedByColumnOnce[column], [this, column]() {
+        sortedByColumn[column] = SortedOrder([column](const Bid& a, const Bid& b) {
+            double left = BidColumnStore::NumericValue(a, column);
+            double right = BidColumnStore::NumericValue(b, column);
+            if (left != right) {
+                return left < right;
+            }
+            return a.auctionId < b.auctionId;
+        });
+    });
+    return sortedByColumn[column];
+}
+
+// Row numbers ordered by a date column, ties broken by auction ID
+const std::vector<uint32_t>& BidSnapshot::OrderByDate(BidColumnStore::DateColumn column) const {
+    std::call_once(sortedByDateOnce[column], [this, column]() {
+        // Parse each date once rather than on every comparison
+        std::vector<uint32_t> dates(rows.size());
+        for (size_t row = 0; row < rows.size(); row++) {
+            dates[row] = BidColumnStore::DateValue(*rows[row], column);
+        }
+
+        std::vector<uint32_t>& order = sortedByDate[column];
+        order.resize(rows.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            order[i] = static_cast<uint32_t>(i);
+        }
+        auto byDate = [this, &dates](uint32_t a, uint32_t b) {
+            if (dates[a] != dates[b]) {
+                return dates[a] < dates[b];
+            }
+            return rows[a]->auctionId < rows[b]->auctionId;
+        };
+        sortRows(order, byDate);
+    });
+    return sortedByDate[column];
+}
+
+// Row numbers of the bids whose group column has the given code
+const std::vector<uint32_t>& BidSnapshot::RowsWithCode(BidColumnStore::GroupColumn column, uint32_t code) const {
+    static const std::vector<uint32_t> none;
+
+    std::call_once(rowsByCodeOnce[column], [this, column]() {
+        // Codes come from the shared string pool, so one slot per pooled string is enough
+        std::vector<std::vector<uint32_t>>& lists = rowsByCode[column];
+        lists.resize(InternedString::PoolSize());
+        for (size_t row = 0; row < rows.size(); row++) {
+            uint32_t rowCode = BidColumnStore::GroupCode(*rows[row], column);
+            if (rowCode >= lists.size()) {
+                lists.resize(rowCode + 1);
+            }
+            lists[rowCode].push_back(static_cast<uint32_t>(row));
+        }
+    });
+
+    const std::vector<std::vector<uint32_t>>& lists = rowsByCode[column];
+    return (code < lists.size()) ? lists[code] : none;
+}
+
+BidView::BidView(std::shared_ptr<const BidSnapshot> aSnapshot)
+    : snapshot(std::move(aSnapshot)), allRows(true) {}
+
+BidView::BidView(std::shared_ptr<const BidSnapshot> aSnapshot, std::vector<uint32_t> anOrder)
+    : snapshot(std::move(aSnapshot)), order(std::move(anOrder)), allRows(false) {}
+
+size_t BidView::size() const {
+    return allRows ? snapshot->size() : order.size();
+}
+
+const Bid& BidView::operator[](size_t position) const {
+    return (*snapshot)[allRows ? position : order[position]];
+}
+
+BidView::const_iterator BidView::begin() const {
+    return const_iterator(this, 0);
+}
+
+BidView::const_iterator BidView::end() const {
+    return const_iterator(this, size());
+}
+
+std::vector<Bid> BidView::ToVector() const {
+    std::vector<Bid> bids;
+    bids.reserve(size());
+    for (const Bid& bid : *this) {
+        bids.push_back(bid);
+    }
+    return bids;
+}
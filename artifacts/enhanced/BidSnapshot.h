@@ -0,0 +1,208 @@
+/*
+ * File: BidSnapshot.h
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file defines the BidSnapshot and BidView classes. A BidSnapshot is an
+ * immutable, reference-counted view of the bid set at one point in time. It holds
+ * shared pointers to the same immutable Bid records as the live list, so taking a
+ * snapshot never copies bid fields, and a snapshot stays valid after the list is
+ * modified. A BidView is a snapshot plus a row order, which is how sorted and
+ * filtered results are returned: one index permutation instead of a copy of the data.
+ *
+ * A snapshot also answers sorted and filtered queries. The row orders and group
+ * lists behind them are built the first time they are needed and then shared by every
+ * reader of that snapshot, so readers never need a lock on the live list.
+ *
+ * Dependencies:
+ * - Bid.h for the Bid structure
+ * - BidColumnStore.h for the column values rows are ordered and grouped by
+ *
+ */
+
+#pragma once
+#include "Bid.h"
+#include "BidColumnStore.h"
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+
+class BidSnapshot {
+private:
+    std::vector<BidPtr> rows;
+
+    // Built on first use; the rows never change, so each is built at most once
+    mutable std::once_flag sortedByIdOnce;
+    mutable std::vector<uint32_t> sortedById;
+    mutable std::once_flag sortedByColumnOnce[BidColumnStore::NumericColumnCount];
+    mutable std::vector<uint32_t> sortedByColumn[BidColumnStore::NumericColumnCount];
+    mutable std::once_flag sortedByDateOnce[BidColumnStore::DateColumnCount];
+    mutable std::vector<uint32_t> sortedByDate[BidColumnStore::DateColumnCount];
+    mutable std::once_flag rowsByCodeOnce[BidColumnStore::GroupColumnCount];
+    mutable std::vector<std::vector<uint32_t>> rowsByCode[BidColumnStore::GroupColumnCount];
+
+    // Stable sort of row numbers. Large inputs are cut into one run per core, the runs
+    // are sorted concurrently and then merged pairwise, one round at a time. The
+    // comparator is shared by all threads and must be safe to call concurrently.
+    template <typename Compare>
+    static void sortRows(std::vector<uint32_t>& order, Compare& comparator);
+
+public:
+    explicit BidSnapshot(std::vector<BidPtr> aRows);
+
+    // Snapshot whose order by auction ID is already known, e.g. from a sorted index
+    BidSnapshot(std::vector<BidPtr> aRows, std::vector<uint32_t> anOrderById);
+
+    size_t size() const;
+    const Bid& operator[](size_t row) const;
+    const BidPtr& Get(size_t row) const;
+
+    // Row numbers ordered by auction ID
+    const std::vector<uint32_t>& OrderById() const;
+
+    // Row numbers ordered by a numeric column, ties broken by auction ID
+    const std::vector<uint32_t>& OrderBy(BidColumnStore::NumericColumn column) const;
+
+    // Row numbers ordered by a date column, ties broken by auction ID
+    const std::vector<uint32_t>& OrderByDate(BidColumnStore::DateColumn column) const;
+
+    // Row numbers, in snapshot order, of the bids whose group column has the given
+    // InternedString code. The index covers every code of that column at once.
+    const std::vector<uint32_t>& RowsWithCode(BidColumnStore::GroupColumn column, uint32_t code) const;
+
+    // Row numbers of every bid, ordered by the comparator (stable)
+    template <typename Compare>
+    std::vector<uint32_t> SortedOrder(Compare comparator) const;
+
+    // Row numbers of the bids matching the predicate, in snapshot order
+    template <typename Predicate>
+    std::vector<uint32_t> Filter(Predicate predicate) const;
+};
+
+class BidView {
+private:
+    std::shared_ptr<const BidSnapshot> snapshot;
+    std::vector<uint32_t> order;
+    bool allRows;  // True when the view is every row in snapshot order
+
+public:
+    class const_iterator {
+    private:
+        const BidView* view;
+        size_t position;
+
+    public:
+        const_iterator(const BidView* aView, size_t aPosition) : view(aView), position(aPosition) {}
+        const Bid& operator*() const { return (*view)[position]; }
+        const Bid* operator->() const { return &(*view)[position]; }
+        const_iterator& operator++() { position++; return *this; }
+        bool operator==(const const_iterator& other) const { return position == other.position; }
+        bool operator!=(const const_iterator& other) const { return position != other.position; }
+    };
+
+    // View of every row of a snapshot, in snapshot order
+    explicit BidView(std::shared_ptr<const BidSnapshot> aSnapshot);
+
+    // View of selected rows of a snapshot, in the given order
+    BidView(std::shared_ptr<const BidSnapshot> aSnapshot, std::vector<uint32_t> anOrder);
+
+    size_t size() const;
+    const Bid& operator[](size_t position) const;
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    // Materialize the view as independent Bid copies
+    std::vector<Bid> ToVector() const;
+};
+
+template <typename Compare>
+std::vector<uint32_t> BidSnapshot::SortedOrder(Compare comparator) const {
+    std::vector<uint32_t> order(rows.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+
+    const std::vector<BidPtr>& data = rows;
+    auto byRow = [&data, &comparator](uint32_t a, uint32_t b) {
+        return comparator(*data[a], *data[b]);
+    };
+    sortRows(order, byRow);
+    return order;
+}
+
+template <typename Compare>
+void BidSnapshot::sortRows(std::vector<uint32_t>& order, Compare& comparator) {
+    // Below this size thread startup costs more than it saves
+    const size_t minParallelSize = 16384;
+
+    size_t threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+    if (threadCount < 2 || order.size() < minParallelSize) {
+        std::stable_sort(order.begin(), order.end(), comparator);
+        return;
+    }
+
+    // Cut the rows into threadCount runs of roughly equal length; run i is
+    // [bounds[i], bounds[i + 1])
+    std::vector<size_t> bounds;
+    size_t runLength = (order.size() + threadCount - 1) / threadCount;
+    for (size_t start = 0; start < order.size(); start += runLength) {
+        bounds.push_back(start);
+    }
+    bounds.push_back(order.size());
+
+    // Sort every run on its own thread
+    std::vector<uint32_t>::iterator first = order.begin();
+    std::vector<std::thread> workers;
+    workers.reserve(bounds.size() - 1);
+    for (size_t i = 0; i + 1 < bounds.size(); i++) {
+        workers.emplace_back([first, &bounds, &comparator, i]() {
+            std::stable_sort(first + bounds[i], first + bounds[i + 1], comparator);
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // Merge neighbouring runs pairwise, one round at a time, in parallel. Merges
+    // are stable and take ties from the left run, so the whole sort is stable.
+    while (bounds.size() > 2) {
+        std::vector<std::thread> mergers;
+        mergers.reserve(bounds.size() / 2);
+        for (size_t i = 0; i + 2 < bounds.size(); i += 2) {
+            mergers.emplace_back([first, &bounds, &comparator, i]() {
+                std::inplace_merge(first + bounds[i], first + bounds[i + 1], first + bounds[i + 2], comparator);
+            });
+        }
+        for (std::thread& merger : mergers) {
+            merger.join();
+        }
+
+        std::vector<size_t> merged;
+        merged.reserve(bounds.size() / 2 + 2);
+        for (size_t i = 0; i < bounds.size(); i += 2) {
+            merged.push_back(bounds[i]);
+        }
+        if (merged.back() != order.size()) {
+            merged.push_back(order.size());
+        }
+        bounds.swap(merged);
+    }
+}
+
+template <typename Predicate>
+std::vector<uint32_t> BidSnapshot::Filter(Predicate predicate) const {
+    std::vector<uint32_t> matches;
+    for (size_t i = 0; i < rows.size(); i++) {
+        if (predicate(*rows[i])) {
+            matches.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return matches;
+}
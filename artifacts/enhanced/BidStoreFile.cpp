@@ -0,0 +1,357 @@
+/*
+ * File: BidStoreFile.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file implements reading and writing of the binary bid store file.
+ *
+ * Dependencies:
+ * - BidStoreFile.h
+ * - HashIndex.h to pool repeated strings while writing
+ * - CSVparser.h for MappedFile
+ * - InventoryIndex.h to split inventory lists while writing
+ *
+ */
+
+#include "BidStoreFile.h"
+#include "HashIndex.h"
+#include "CSVparser.h"
+#include "InventoryIndex.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string_view>
+#include <filesystem>
+#include <stdexcept>
+
+namespace {
+    const char magic[8] = { 'B', 'I', 'D', 'S', 'T', 'O', 'R', 'E' };
+    const uint32_t byteOrderMark = 0x01020304u;
+
+    const size_t numberFields = 8;
+    const size_t stringFields = 13;
+
+    // Bids handed to the sink at a time while loading
+    const size_t loadBatchSize = 65536;
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint64_t generation;
+        uint64_t bidCount;
+        uint64_t poolOffset;
+        uint64_t poolSize;
+        uint64_t tableOffset;
+        uint64_t stringCount;
+        uint64_t recordsOffset;
+        uint64_t inventoryOffset;
+        uint64_t inventoryCount;
+        uint64_t fileSize;
+        uint64_t checksum;    // Of every byte after the header
+    };
+
+    struct StringEntry {
+        uint64_t offset;      // From the start of the pool
+        uint64_t length;
+    };
+
+    struct Record {
+        double numbers[numberFields];
+        uint32_t strings[stringFields];
+        uint32_t reserved;
+    };
+
+    // One item of a bid's inventory list
+    struct InventoryEntry {
+        uint32_t item;        // String-table index
+        uint32_t record;
+    };
+
+    static_assert(sizeof(FileHeader) % 8 == 0, "header must keep sections aligned");
+    static_assert(sizeof(Record) % 8 == 0, "records must stay aligned");
+    static_assert(sizeof(InventoryEntry) % 8 == 0, "inventory entries must stay aligned");
+
+    uint64_t align8(uint64_t value) {
+        return (value + 7) & ~static_cast<uint64_t>(7);
+    }
+
+    // 64-bit FNV-1a over whole words, then the trailing bytes
+    uint64_t checksum(const char* data, size_t size) {
+        uint64_t h = 14695981039346656037ULL;
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, data + i, 8);
+            h ^= word;
+            h *= 1099511628211ULL;
+        }
+        for (; i < size; i++) {
+            h ^= static_cast<unsigned char>(data[i]);
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    void fillNumbers(const Bid& bid, double* numbers) {
+        numbers[0] = bid.winningBid;
+        numbers[1] = bid.ccFee;
+        numbers[2] = bid.feePercent;
+        numbers[3] = bid.auctionFeeSubtotal;
+        numbers[4] = bid.auctionFeeTotal;
+        numbers[5] = bid.cap;
+        numbers[6] = bid.expenses;
+        numbers[7] = bid.netSales;
+    }
+
+    void readNumbers(const double* numbers, Bid& bid) {
+        bid.winningBid = numbers[0];
+        bid.ccFee = numbers[1];
+        bid.feePercent = numbers[2];
+        bid.auctionFeeSubtotal = numbers[3];
+        bid.auctionFeeTotal = numbers[4];
+        bid.cap = numbers[5];
+        bid.expenses = numbers[6];
+        bid.netSales = numbers[7];
+    }
+
+    // Builds the deduplicated string pool while writing
+    class PoolBuilder {
+    public:
+        std::string pool;
+        std::vector<StringEntry> table;
+
+        uint32_t Add(std::string_view value) {
+            const uint32_t* existing = index.Find(value);
+            if (existing != nullptr) {
+                return *existing;
+            }
+            uint32_t id = static_cast<uint32_t>(table.size());
+            table.push_back(StringEntry{ pool.size(), value.size() });
+            pool.append(value);
+            index.Insert(value, id);
+            return id;
+        }
+
+    private:
+        HashIndex<uint32_t> index;
+    };
+}
+
+// Write the bids to path
+void BidStoreFile::Write(const std::string& path, const BidSnapshot& bids, uint64_t generation) {
+    PoolBuilder strings;
+    std::vector<Record> records(bids.size());
+    std::vector<InventoryEntry> inventory;
+
+    for (size_t i = 0; i < bids.size(); i++) {
+        const Bid& bid = bids[i];
+        Record& record = records[i];
+        fillNumbers(bid, record.numbers);
+
+        // Text fields in a fixed order; the last four are the interned ones
+        const std::string* text[stringFields] = {
+            &bid.auctionTitle, &bid.auctionId, &bid.closeDate, &bid.paidDate, &bid.assetNumber,
+            &bid.inventoryId, &bid.decalVehicleId, &bid.vtrNumber, &bid.receiptNumber,
+            &bid.department.str(), &bid.payStatus.str(), &bid.fund.str(), &bid.businessUnit.str()
+        };
+        for (size_t f = 0; f < stringFields; f++) {
+            record.strings[f] = strings.Add(*text[f]);
+        }
+        record.reserved = 0;
+
+        for (std::string_view item : InventoryIndex::Items(bid.inventoryId)) {
+            inventory.push_back(InventoryEntry{ strings.Add(item), static_cast<uint32_t>(i) });
+        }
+    }
+
+    FileHeader header;
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = Version;
+    header.byteOrder = byteOrderMark;
+    header.generation = generation;
+    header.bidCount = records.size();
+    header.poolOffset = sizeof(FileHeader);
+    header.poolSize = strings.pool.size();
+    header.tableOffset = align8(header.poolOffset + header.poolSize);
+    header.stringCount = strings.table.size();
+    header.recordsOffset = header.tableOffset + header.stringCount * sizeof(StringEntry);
+    header.inventoryOffset = header.recordsOffset + header.bidCount * sizeof(Record);
+    header.inventoryCount = inventory.size();
+    header.fileSize = header.inventoryOffset + header.inventoryCount * sizeof(InventoryEntry);
+
+    // Assemble the payload in memory so it can be checksummed and written at once
+    // (offsets in the header count from the start of the file, the payload starts after the header)
+    std::string payload(header.fileSize - sizeof(FileHeader), '\0');
+    std::memcpy(&payload[0], strings.pool.data(), strings.pool.size());
+    if (!strings.table.empty()) {
+        std::memcpy(&payload[header.tableOffset - sizeof(FileHeader)], strings.table.data(), strings.table.size() * sizeof(StringEntry));
+    }
+    if (!records.empty()) {
+        std::memcpy(&payload[header.recordsOffset - sizeof(FileHeader)], records.data(), records.size() * sizeof(Record));
+    }
+    if (!inventory.empty()) {
+        std::memcpy(&payload[header.inventoryOffset - sizeof(FileHeader)], inventory.data(), inventory.size() * sizeof(InventoryEntry));
+    }
+    header.checksum = checksum(payload.data(), payload.size());
+
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to create bid store file " + temporary);
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        file.flush();
+        if (!file) {
+            throw std::runtime_error("Failed to write bid store file " + temporary);
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temporary, path, ec);
+    if (ec) {
+        std::filesystem::remove(temporary, ec);
+        throw std::runtime_error("Failed to replace bid store file " + path);
+    }
+}
+
+// Load the bids of a file written for the given generation
+bool BidStoreFile::Read(const std::string& path, uint64_t generation,
+                        const std::function<void(std::vector<Bid>&)>& sink,
+                        const std::function<void(std::string_view, std::string_view)>& inventorySink,
+                        std::string& error) {
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec)) {
+        error = "no bid store file";
+        return false;
+    }
+
+    std::unique_ptr<csv::MappedFile> map;
+    try {
+        map.reset(new csv::MappedFile(path));
+    }
+    catch (const std::exception& e) {
+        error = e.what();
+        return false;
+    }
+
+    // Check the header before trusting any offset in it
+    FileHeader header;
+    if (map->size() < sizeof(FileHeader)) {
+        error = "file is truncated";
+        return false;
+    }
+    std::memcpy(&header, map->data(), sizeof(header));
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0) {
+        error = "not a bid store file";
+        return false;
+    }
+    if (header.version != Version || header.byteOrder != byteOrderMark) {
+        error = "unsupported format version or byte order";
+        return false;
+    }
+    if (header.generation != generation) {
+        error = "file is stale";
+        return false;
+    }
+    if (header.fileSize != map->size()
+        || header.poolOffset != sizeof(FileHeader)
+        || header.poolSize > map->size() - header.poolOffset
+        || header.tableOffset != align8(header.poolOffset + header.poolSize)
+        || header.stringCount > (map->size() - header.tableOffset) / sizeof(StringEntry)
+        || header.recordsOffset != header.tableOffset + header.stringCount * sizeof(StringEntry)
+        || header.bidCount > (map->size() - header.recordsOffset) / sizeof(Record)
+        || header.inventoryOffset != header.recordsOffset + header.bidCount * sizeof(Record)
+        || header.inventoryCount > (map->size() - header.inventoryOffset) / sizeof(InventoryEntry)
+        || header.inventoryOffset + header.inventoryCount * sizeof(InventoryEntry) != map->size()) {
+        error = "section offsets do not match the file size";
+        return false;
+    }
+    if (checksum(map->data() + sizeof(FileHeader), map->size() - sizeof(FileHeader)) != header.checksum) {
+        error = "checksum mismatch";
+        return false;
+    }
+
+    const char* pool = map->data() + header.poolOffset;
+    const StringEntry* table = reinterpret_cast<const StringEntry*>(map->data() + header.tableOffset);
+    const Record* records = reinterpret_cast<const Record*>(map->data() + header.recordsOffset);
+    const InventoryEntry* inventory = reinterpret_cast<const InventoryEntry*>(map->data() + header.inventoryOffset);
+
+    // Verify every reference so decoding below cannot fail part way through
+    for (uint64_t s = 0; s < header.stringCount; s++) {
+        if (table[s].offset > header.poolSize || table[s].length > header.poolSize - table[s].offset) {
+            error = "string table entry out of range";
+            return false;
+        }
+    }
+    for (uint64_t r = 0; r < header.bidCount; r++) {
+        for (size_t f = 0; f < stringFields; f++) {
+            if (records[r].strings[f] >= header.stringCount) {
+                error = "record refers to a missing string";
+                return false;
+            }
+        }
+    }
+    for (uint64_t e = 0; e < header.inventoryCount; e++) {
+        if (inventory[e].item >= header.stringCount || inventory[e].record >= header.bidCount) {
+            error = "inventory entry out of range";
+            return false;
+        }
+    }
+
+    auto text = [&](uint32_t id) {
+        return std::string_view(pool + table[id].offset, static_cast<size_t>(table[id].length));
+    };
+
+    // Each distinct interned value goes through the string pool once
+    std::vector<InternedString> interned(header.stringCount);
+    std::vector<bool> isInterned(header.stringCount, false);
+    auto intern = [&](uint32_t id) {
+        if (!isInterned[id]) {
+            interned[id] = InternedString(text(id));
+            isInterned[id] = true;
+        }
+        return interned[id];
+    };
+
+    std::vector<Bid> batch;
+    batch.reserve(std::min<uint64_t>(header.bidCount, loadBatchSize));
+    for (uint64_t r = 0; r < header.bidCount; r++) {
+        const Record& record = records[r];
+        Bid bid;
+        readNumbers(record.numbers, bid);
+        bid.auctionTitle = text(record.strings[0]);
+        bid.auctionId = text(record.strings[1]);
+        bid.closeDate = text(record.strings[2]);
+        bid.paidDate = text(record.strings[3]);
+        bid.assetNumber = text(record.strings[4]);
+        bid.inventoryId = text(record.strings[5]);
+        bid.decalVehicleId = text(record.strings[6]);
+        bid.vtrNumber = text(record.strings[7]);
+        bid.receiptNumber = text(record.strings[8]);
+        bid.department = intern(record.strings[9]);
+        bid.payStatus = intern(record.strings[10]);
+        bid.fund = intern(record.strings[11]);
+        bid.businessUnit = intern(record.strings[12]);
+        batch.push_back(std::move(bid));
+
+        if (batch.size() == loadBatchSize) {
+            sink(batch);
+            batch.clear();
+        }
+    }
+    if (!batch.empty()) {
+        sink(batch);
+    }
+
+    for (uint64_t e = 0; e < header.inventoryCount; e++) {
+        inventorySink(text(inventory[e].item), text(records[inventory[e].record].strings[1]));
+    }
+    return true;
+}
@@ -0,0 +1,63 @@
+/*
+ * File: BidStoreFile.h
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file defines the BidStoreFile class, which saves the in-memory bids to a
+ * compact binary file and loads them back at startup, so a restart does not have
+ * to run and convert SELECT * FROM bids.
+ *
+ * File layout (native byte order, checked through a byte-order mark; every
+ * section 8-byte aligned):
+ *   header      magic, format version, byte-order mark, database generation,
+ *               counts and offsets of the sections below, payload checksum
+ *   string pool every distinct text value, stored once, back to back
+ *   string table (offset, length) of each pooled string
+ *   records     one fixed-size record per bid: eight doubles and thirteen
+ *               string-table indexes
+ *   inventory   (string-table index, record number) for every item of every
+ *               bid's inventoryId list, so the inventory index is loaded
+ *               without splitting the lists again
+ *
+ * The generation is the value of the database's change counter when the file
+ * was written. A file whose generation does not match the database, whose
+ * version is unknown, or whose checksum or indexes do not verify is rejected,
+ * and the caller falls back to loading from SQLite.
+ *
+ * Dependencies:
+ * - Bid.h for the Bid structure
+ * - BidSnapshot.h for the bids being saved
+ *
+ */
+
+#pragma once
+#include "Bid.h"
+#include "BidSnapshot.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+class BidStoreFile {
+public:
+    // Current format version; files with any other version are rejected
+    static const uint32_t Version = 2;
+
+    // Write the bids to path. The file is written under a temporary name and
+    // renamed into place, so a reader never sees a partial file.
+    static void Write(const std::string& path, const BidSnapshot& bids, uint64_t generation);
+
+    // Load the bids of a file written for the given generation, passing them to
+    // sink in batches, then pass each (inventory item, auction ID) pair to
+    // inventorySink. The whole file is verified before the first batch, so on
+    // failure nothing has been passed to either sink. Returns false, with the
+    // reason in error, if the file is missing, stale or corrupt.
+    static bool Read(const std::string& path, uint64_t generation,
+                     const std::function<void(std::vector<Bid>&)>& sink,
+                     const std::function<void(std::string_view, std::string_view)>& inventorySink,
+                     std::string& error);
+};
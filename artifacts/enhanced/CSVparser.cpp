@@ -3,10 +3,237 @@
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <cstring>
+#include <cstdint>
 #include "CSVparser.h"
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CSV_X86_64 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define CSV_TARGET_AVX2
+#else
+#define CSV_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
 namespace csv {
 
+  /*
+  ** TOKENIZER
+  **
+  ** A separator splits fields unless it sits inside double quotes, and every quote
+  ** toggles the quoted state. The vector kernels compare 16 or 32 bytes at once
+  ** against the quote and the separator, turning each into a bitmask. The prefix
+  ** XOR of the quote mask has bit i set when an odd number of quotes precede or sit
+  ** at byte i, which is exactly the quoted state at that byte, so the separators
+  ** outside quotes are sepMask & ~quotedMask. The kernel is picked once at startup
+  ** from what the CPU supports.
+  */
+
+  typedef void (*DelimiterScan)(const char *data, size_t length, char sep, std::vector<size_t> &delimiters);
+
+  // Scalar scan of data[begin, length), continuing from the given quoted state
+  static void scanScalarFrom(const char *data, size_t begin, size_t length, char sep, bool quoted,
+                             std::vector<size_t> &delimiters)
+  {
+      for (size_t i = begin; i != length; i++)
+      {
+           if (data[i] == '"')
+               quoted = ((quoted) ? (false) : (true));
+           else if (data[i] == sep && !quoted)
+               delimiters.push_back(i);
+      }
+  }
+
+  static void scanScalar(const char *data, size_t length, char sep, std::vector<size_t> &delimiters)
+  {
+      scanScalarFrom(data, 0, length, sep, false, delimiters);
+  }
+
+#ifdef CSV_X86_64
+  // Bit i of the result is the XOR of bits 0..i of mask
+  static inline uint32_t prefixXor(uint32_t mask)
+  {
+      mask ^= mask << 1;
+      mask ^= mask << 2;
+      mask ^= mask << 4;
+      mask ^= mask << 8;
+      mask ^= mask << 16;
+      return mask;
+  }
+
+  static inline unsigned lowestBit(uint32_t mask)
+  {
+#ifdef _MSC_VER
+      unsigned long index;
+      _BitScanForward(&index, mask);
+      return static_cast<unsigned>(index);
+#else
+      return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+  }
+
+  // Record every separator in one block and return the quoted state after it
+  static inline bool emitBlock(uint32_t quoteMask, uint32_t sepMask, uint32_t fullMask, unsigned lastBit,
+                               bool quoted, size_t base, std::vector<size_t> &delimiters)
+  {
+      uint32_t inside = (prefixXor(quoteMask) ^ (quoted ? fullMask : 0)) & fullMask;
+      uint32_t split = sepMask & ~quoteMask & ~inside;
+      while (split)
+      {
+          delimiters.push_back(base + lowestBit(split));
+          split &= split - 1;
+      }
+      return ((inside >> lastBit) & 1) != 0;
+  }
+
+  static void scanSSE2(const char *data, size_t length, char sep, std::vector<size_t> &delimiters)
+  {
+      const __m128i quote = _mm_set1_epi8('"');
+      const __m128i separator = _mm_set1_epi8(sep);
+      bool quoted = false;
+      size_t i = 0;
+
+      for (; i + 16 <= length; i += 16)
+      {
+          __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+          uint32_t quoteMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, quote)));
+          uint32_t sepMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, separator)));
+          quoted = emitBlock(quoteMask, sepMask, 0xFFFFu, 15, quoted, i, delimiters);
+      }
+      scanScalarFrom(data, i, length, sep, quoted, delimiters);
+  }
+
+  CSV_TARGET_AVX2 static void scanAVX2(const char *data, size_t length, char sep, std::vector<size_t> &delimiters)
+  {
+      const __m256i quote = _mm256_set1_epi8('"');
+      const __m256i separator = _mm256_set1_epi8(sep);
+      bool quoted = false;
+      size_t i = 0;
+
+      for (; i + 32 <= length; i += 32)
+      {
+          __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+          uint32_t quoteMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, quote)));
+          uint32_t sepMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, separator)));
+          quoted = emitBlock(quoteMask, sepMask, 0xFFFFFFFFu, 31, quoted, i, delimiters);
+      }
+      scanScalarFrom(data, i, length, sep, quoted, delimiters);
+  }
+
+  // AVX2 needs both CPU support and the OS saving the wider registers
+  static bool cpuHasAVX2(void)
+  {
+#ifdef _MSC_VER
+      int info[4];
+      __cpuid(info, 0);
+      if (info[0] < 7)
+        return false;
+      __cpuid(info, 1);
+      bool osxsave = (info[2] & (1 << 27)) != 0;
+      bool avx = (info[2] & (1 << 28)) != 0;
+      if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+      __cpuidex(info, 7, 0);
+      return (info[1] & (1 << 5)) != 0;
+#else
+      return __builtin_cpu_supports("avx2");
+#endif
+  }
+#endif
+
+  static DelimiterScan selectDelimiterScan(void)
+  {
+#ifdef CSV_X86_64
+      if (cpuHasAVX2())
+        return scanAVX2;
+      return scanSSE2;  // Always available on x86-64
+#else
+      return scanScalar;
+#endif
+  }
+
+  // The kernel picked for this CPU, chosen on first use
+  static DelimiterScan bestDelimiterScan(void)
+  {
+      static const DelimiterScan scanDelimiters = selectDelimiterScan();
+      return scanDelimiters;
+  }
+
+  // A kernel by name, or null if this CPU cannot run it
+  static DelimiterScan delimiterScanFor(ScanKernel kernel)
+  {
+      switch (kernel)
+      {
+      case ScanKernel::Scalar:
+          return scanScalar;
+#ifdef CSV_X86_64
+      case ScanKernel::SSE2:
+          return scanSSE2;
+      case ScanKernel::AVX2:
+          return (bestDelimiterScan() == scanAVX2) ? scanAVX2 : nullptr;
+#endif
+      case ScanKernel::Best:
+          return bestDelimiterScan();
+      default:
+          return nullptr;
+      }
+  }
+
+  // Split one line into fields with the given kernel, honouring double-quoted
+  // separators, and pass each field to emit as a view into the line
+  template <typename Emit>
+  static void splitLineWith(DelimiterScan scanDelimiters, std::string_view line, char sep, Emit emit)
+  {
+      thread_local std::vector<size_t> delimiters;
+      delimiters.clear();
+      scanDelimiters(line.data(), line.size(), sep, delimiters);
+
+      size_t tokenStart = 0;
+      for (size_t delimiter : delimiters)
+      {
+          emit(line.substr(tokenStart, delimiter - tokenStart));
+          tokenStart = delimiter + 1;
+      }
+
+      //end
+      emit(line.substr(tokenStart));
+  }
+
+  // Split one line with the kernel picked for this CPU
+  template <typename Emit>
+  static void splitLine(std::string_view line, char sep, Emit emit)
+  {
+      splitLineWith(bestDelimiterScan(), line, sep, emit);
+  }
+
+  bool scanKernelSupported(ScanKernel kernel)
+  {
+      return delimiterScanFor(kernel) != nullptr;
+  }
+
+  void splitFields(std::string_view line, char sep, std::vector<std::string_view> &fields, ScanKernel kernel)
+  {
+      DelimiterScan scanDelimiters = delimiterScanFor(kernel);
+      if (scanDelimiters == nullptr)
+        throw Error("Scan kernel not supported on this CPU");
+      fields.clear();
+      splitLineWith(scanDelimiters, line, sep, [&fields](std::string_view field) { fields.push_back(field); });
+  }
+
   Parser::Parser(const std::string &data, const DataType &type, char sep)
     : _type(type), _sep(sep)
   {
@@ -74,29 +301,16 @@ namespace csv {
 
      for (; it != _originalFile.end(); it++)
      {
-         bool quoted = false;
-         int tokenStart = 0;
-         unsigned int i = 0;
-
          Row *row = new Row(_header);
 
-         for (; i != it->length(); i++)
-         {
-              if (it->at(i) == '"')
-                  quoted = ((quoted) ? (false) : (true));
-              else if (it->at(i) == ',' && !quoted)
-              {
-                  row->push(it->substr(tokenStart, i - tokenStart));
-                  tokenStart = i + 1;
-              }
-         }
-
-         //end
-         row->push(it->substr(tokenStart, it->length() - tokenStart));
+         splitLine(*it, _sep, [row](std::string_view field) { row->push(std::string(field)); });
 
          // if value(s) missing
          if (row->size() != _header.size())
+         {
+          delete row;
           throw Error("corrupted data !");
+         }
          _content.push_back(row);
      }
   }
@@ -191,12 +405,404 @@ namespace csv {
       return _file;    
   }
   
+  /*
+  ** READER
+  */
+
+  Reader::Reader(const std::string &file, char sep, size_t bufferSize)
+    : _file(file), _stream(file.c_str(), std::ios::in | std::ios::binary), _sep(sep),
+      _buffer(bufferSize > 0 ? bufferSize : 1), _pos(0), _end(0), _lineNumber(0)
+  {
+      if (!_stream.is_open())
+        throw Error(std::string("Failed to open ").append(_file));
+
+      // The first non-empty line is the header
+      do
+      {
+        if (!readLine(_line))
+          throw Error(std::string("No Data in ").append(_file));
+      } while (_line.empty());
+
+      std::stringstream ss(_line);
+      std::string item;
+
+      while (std::getline(ss, item, _sep))
+          _header.push_back(item);
+  }
+
+  // Read the next line into line, refilling the buffer as needed. A CRLF line
+  // ending is dropped along with the LF, as nextMappedLine does for the mapped
+  // readers. Returns false once the file is exhausted.
+  bool Reader::readLine(std::string &line)
+  {
+      line.clear();
+      for (;;)
+      {
+        if (_pos == _end)
+        {
+          _stream.read(_buffer.data(), _buffer.size());
+          _end = static_cast<size_t>(_stream.gcount());
+          _pos = 0;
+          if (_end == 0)
+          {
+            if (line.empty())
+              return false;
+            if (line.back() == '\r')
+              line.pop_back();
+            _lineNumber++;
+            return true;  // last line had no newline
+          }
+        }
+
+        const char *start = _buffer.data() + _pos;
+        const char *newline = static_cast<const char *>(std::memchr(start, '\n', _end - _pos));
+        if (newline)
+        {
+          line.append(start, newline - start);
+          if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+          _pos += (newline - start) + 1;
+          _lineNumber++;
+          return true;
+        }
+        line.append(start, _end - _pos);
+        _pos = _end;
+      }
+  }
+
+  // Parse the next non-empty line into row. Returns false at end of file.
+  bool Reader::next(Row &row)
+  {
+      do
+      {
+        if (!readLine(_line))
+          return false;
+      } while (_line.empty());
+
+      row.clear();
+      splitLine(_line, _sep, [&row](std::string_view field) { row.push(std::string(field)); });
+
+      // if value(s) missing
+      if (row.size() != _header.size())
+        throw Error("corrupted data at line " + std::to_string(_lineNumber) + " !");
+      return true;
+  }
+
+  const std::vector<std::string> &Reader::getHeader(void) const
+  {
+      return _header;
+  }
+
+  unsigned int Reader::columnCount(void) const
+  {
+      return _header.size();
+  }
+
+  unsigned long Reader::lineNumber(void) const
+  {
+      return _lineNumber;
+  }
+
+  const std::string &Reader::getFileName(void) const
+  {
+      return _file;
+  }
+
+  /*
+  ** MAPPED FILE
+  */
+
+#ifdef _WIN32
+  MappedFile::MappedFile(const std::string &file)
+    : _data(nullptr), _size(0), _fileHandle(INVALID_HANDLE_VALUE), _mappingHandle(nullptr)
+  {
+      HANDLE fileHandle = CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                      OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+      if (fileHandle == INVALID_HANDLE_VALUE)
+        throw Error(std::string("Failed to open ").append(file));
+      _fileHandle = fileHandle;
+
+      LARGE_INTEGER size;
+      if (!GetFileSizeEx(fileHandle, &size))
+      {
+        CloseHandle(fileHandle);
+        throw Error(std::string("Failed to read size of ").append(file));
+      }
+      _size = static_cast<size_t>(size.QuadPart);
+      if (_size == 0)
+        return;  // Nothing to map
+
+      HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      void *view = mappingHandle ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+      if (view == nullptr)
+      {
+        if (mappingHandle)
+          CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        throw Error(std::string("Failed to map ").append(file));
+      }
+      _mappingHandle = mappingHandle;
+      _data = static_cast<const char *>(view);
+  }
+
+  MappedFile::~MappedFile(void)
+  {
+      if (_data)
+        UnmapViewOfFile(_data);
+      if (_mappingHandle)
+        CloseHandle(_mappingHandle);
+      if (_fileHandle != INVALID_HANDLE_VALUE)
+        CloseHandle(_fileHandle);
+  }
+#else
+  MappedFile::MappedFile(const std::string &file)
+    : _data(nullptr), _size(0), _fd(-1)
+  {
+      _fd = open(file.c_str(), O_RDONLY);
+      if (_fd < 0)
+        throw Error(std::string("Failed to open ").append(file));
+
+      struct stat info;
+      if (fstat(_fd, &info) != 0)
+      {
+        close(_fd);
+        throw Error(std::string("Failed to read size of ").append(file));
+      }
+      _size = static_cast<size_t>(info.st_size);
+      if (_size == 0)
+        return;  // mmap rejects empty mappings
+
+      void *view = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+      if (view == MAP_FAILED)
+      {
+        close(_fd);
+        throw Error(std::string("Failed to map ").append(file));
+      }
+      madvise(view, _size, MADV_SEQUENTIAL);
+      _data = static_cast<const char *>(view);
+  }
+
+  MappedFile::~MappedFile(void)
+  {
+      if (_data)
+        munmap(const_cast<char *>(_data), _size);
+      if (_fd >= 0)
+        close(_fd);
+  }
+#endif
+
+  const char *MappedFile::data(void) const
+  {
+      return _data;
+  }
+
+  size_t MappedFile::size(void) const
+  {
+      return _size;
+  }
+
+  /*
+  ** MAPPED READER
+  */
+
+  MappedReader::MappedReader(const std::string &file, char sep)
+    : _file(file), _map(file), _sep(sep), _pos(0), _lineNumber(0)
+  {
+      std::string_view line;
+
+      // The first non-empty line is the header
+      do
+      {
+        if (!readLine(line))
+          throw Error(std::string("No Data in ").append(_file));
+      } while (line.empty());
+
+      std::stringstream ss{std::string(line)};
+      std::string item;
+
+      while (std::getline(ss, item, _sep))
+          _header.push_back(item);
+  }
+
+  // Point line at the line starting at data[pos], stopping at end, and move pos
+  // past it. A CRLF line ending is dropped along with the LF, as a text-mode stream
+  // would on Windows, so a line holding only "\r" is blank. Returns false when pos
+  // has reached end.
+  static bool nextMappedLine(const char *data, size_t &pos, size_t end, std::string_view &line)
+  {
+      if (pos >= end)
+        return false;
+
+      const char *start = data + pos;
+      size_t remaining = end - pos;
+      const char *newline = static_cast<const char *>(std::memchr(start, '\n', remaining));
+      size_t length = newline ? static_cast<size_t>(newline - start) : remaining;
+      pos += newline ? length + 1 : length;
+
+      if (length > 0 && start[length - 1] == '\r')
+        length--;
+      line = std::string_view(start, length);
+      return true;
+  }
+
+  // Point line at the next line of the mapping. Returns false at end of file.
+  bool MappedReader::readLine(std::string_view &line)
+  {
+      if (!nextMappedLine(_map.data(), _pos, _map.size(), line))
+        return false;
+      _lineNumber++;
+      return true;
+  }
+
+  // Parse the next non-empty line into row. Returns false at end of file.
+  bool MappedReader::next(RowView &row)
+  {
+      std::string_view line;
+      do
+      {
+        if (!readLine(line))
+          return false;
+      } while (line.empty());
+
+      row.clear();
+      splitLine(line, _sep, [&row](std::string_view field) { row.push(field); });
+
+      // if value(s) missing
+      if (row.size() != _header.size())
+        throw Error("corrupted data at line " + std::to_string(_lineNumber) + " !");
+      return true;
+  }
+
+  // Split the rows not yet returned by next() into ranges of about chunkBytes
+  // bytes. Every range ends just after a newline (or at end of file), so no
+  // record is cut in two.
+  std::vector<RangeReader> MappedReader::split(size_t chunkBytes) const
+  {
+      std::vector<RangeReader> ranges;
+      if (chunkBytes == 0)
+        chunkBytes = 1;
+
+      size_t begin = _pos;
+      while (begin < _map.size())
+      {
+          size_t end = _map.size();
+          if (_map.size() - begin > chunkBytes)
+          {
+            // Extend the range to the end of the line that crosses the target size
+            const char *from = _map.data() + begin + chunkBytes - 1;
+            const char *newline = static_cast<const char *>(std::memchr(from, '\n', _map.size() - (begin + chunkBytes - 1)));
+            if (newline)
+              end = static_cast<size_t>(newline - _map.data()) + 1;
+          }
+          ranges.push_back(RangeReader(_map.data(), begin, end, _sep, _header));
+          begin = end;
+      }
+      return ranges;
+  }
+
+  const std::vector<std::string> &MappedReader::getHeader(void) const
+  {
+      return _header;
+  }
+
+  unsigned int MappedReader::columnCount(void) const
+  {
+      return _header.size();
+  }
+
+  unsigned long MappedReader::lineNumber(void) const
+  {
+      return _lineNumber;
+  }
+
+  const std::string &MappedReader::getFileName(void) const
+  {
+      return _file;
+  }
+
+  /*
+  ** RANGE READER
+  */
+
+  RangeReader::RangeReader(const char *data, size_t begin, size_t end, char sep, const std::vector<std::string> &header)
+    : _data(data), _pos(begin), _end(end), _sep(sep), _header(&header), _lineNumber(0) {}
+
+  // Parse the next non-empty line of the range into row. Returns false at the end of the range.
+  bool RangeReader::next(RowView &row)
+  {
+      std::string_view line;
+      do
+      {
+        if (!nextMappedLine(_data, _pos, _end, line))
+          return false;
+        _lineNumber++;
+      } while (line.empty());
+
+      row.clear();
+      splitLine(line, _sep, [&row](std::string_view field) { row.push(field); });
+
+      // if value(s) missing
+      if (row.size() != _header->size())
+        throw Error("corrupted data at line " + std::to_string(_lineNumber) + " of range !");
+      return true;
+  }
+
+  const std::vector<std::string> &RangeReader::getHeader(void) const
+  {
+      return *_header;
+  }
+
+  unsigned long RangeReader::lineNumber(void) const
+  {
+      return _lineNumber;
+  }
+
+  /*
+  ** ROW VIEW
+  */
+
+  RowView::RowView(const std::vector<std::string> &header)
+      : _header(&header) {}
+
+  unsigned int RowView::size(void) const
+  {
+    return _values.size();
+  }
+
+  void RowView::push(std::string_view value)
+  {
+    _values.push_back(value);
+  }
+
+  void RowView::clear(void)
+  {
+    _values.clear();
+  }
+
+  std::string_view RowView::operator[](unsigned int valuePosition) const
+  {
+       if (valuePosition < _values.size())
+           return _values[valuePosition];
+       throw Error("can't return this value (doesn't exist)");
+  }
+
+  std::string_view RowView::operator[](const std::string &key) const
+  {
+      for (unsigned int pos = 0; pos < _header->size(); pos++)
+      {
+          if (key == (*_header)[pos])
+              return _values[pos];
+      }
+
+      throw Error("can't return this value (doesn't exist)");
+  }
+
   /*
   ** ROW
   */
 
   Row::Row(const std::vector<std::string> &header)
-      : _header(header) {}
+      : _header(&header) {}
 
   Row::~Row(void) {}
 
@@ -210,12 +816,17 @@ namespace csv {
     _values.push_back(value);
   }
 
+  void Row::clear(void)
+  {
+    _values.clear();
+  }
+
   bool Row::set(const std::string &key, const std::string &value) 
   {
     std::vector<std::string>::const_iterator it;
     int pos = 0;
 
-    for (it = _header.begin(); it != _header.end(); it++)
+    for (it = _header->begin(); it != _header->end(); it++)
     {
         if (key == *it)
         {
@@ -227,19 +838,19 @@ namespace csv {
     return false;
   }
 
-  const std::string Row::operator[](unsigned int valuePosition) const
+  const std::string &Row::operator[](unsigned int valuePosition) const
   {
        if (valuePosition < _values.size())
            return _values[valuePosition];
        throw Error("can't return this value (doesn't exist)");
   }
 
-  const std::string Row::operator[](const std::string &key) const
+  const std::string &Row::operator[](const std::string &key) const
   {
       std::vector<std::string>::const_iterator it;
       int pos = 0;
 
-      for (it = _header.begin(); it != _header.end(); it++)
+      for (it = _header->begin(); it != _header->end(); it++)
       {
           if (key == *it)
               return _values[pos];
@@ -1,79 +1,206 @@
-/*
- * File: CSVparser.h
- * Author: Thomas Gallegos
- * Email: N/A
- * Date: July 23, 2024
- * Version: 1.0
- *
- * Purpose:
- * This file defines the interface for the CSV parsing functionality.
- * It includes classes for error handling, row representation, and the main parser.
- *
- * Dependencies: None
- *
- */
-
-#pragma once
-#include <vector>
-#include <string>
-#include <iostream>
-
-namespace csv {
-    // Custom error class for CSV parsing errors
-    class Error : public std::exception {
-    public:
-        Error(const std::string& msg) : _msg(msg) {}
-        const char* what() const noexcept { return _msg.c_str(); }
-    private:
-        std::string _msg;
-    };
-
-    // Class representing a row in the CSV
-    class Row {
-    public:
-        Row(const std::vector<std::string>& header);
-        ~Row();
-        unsigned int size() const;
-        void push(const std::string&);
-        bool set(const std::string&, const std::string&);
-        const std::string operator[](unsigned int) const;
-        const std::string operator[](const std::string& valuePosition) const;
-        friend std::ostream& operator<<(std::ostream& os, const Row& row);
-        friend std::ofstream& operator<<(std::ofstream& os, const Row& row);
-    private:
-        const std::vector<std::string> _header;
-        std::vector<std::string> _values;
-    };
-
-    // Enum for specifying the data source type
-    enum class DataType {
-        eFILE = 0,
-        ePURE = 1
-    };
-
-    // Main parser class
-    class Parser {
-    public:
-        Parser(const std::string&, const DataType& type = DataType::eFILE, char sep = ',');
-        ~Parser();
-        Row& getRow(unsigned int row) const;
-        unsigned int rowCount() const;
-        unsigned int columnCount() const;
-        std::vector<std::string> getHeader() const;
-        const std::string getHeaderElement(unsigned int pos) const;
-        const std::string& getFileName() const;
-        bool deleteRow(unsigned int row);
-        bool addRow(unsigned int pos, const std::vector<std::string>&);
-        void sync() const;
-        Row& operator[](unsigned int row) const;
-    private:
-        void parseHeader();
-        void parseContent();
-        std::string _file;
-        const DataType _type;
-        const char _sep;
-        std::vector<std::string> _originalFile;
-        std::vector<std::string> _header;
-        std::vector<Row*> _content;
-    };
-}
+/*
+ * File: CSVparser.h
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file defines the interface for the CSV parsing functionality.
+ * It includes classes for error handling, row representation, the main parser,
+ * which loads the whole file, and a streaming reader, which yields one row at a
+ * time from a fixed-size buffer so large files can be processed in bounded memory.
+ * MappedReader maps the file into memory instead and yields RowView rows whose
+ * fields are std::string_view slices of the mapping, so no field is copied until
+ * the caller decides to keep it.
+ *
+ * Dependencies: None
+ *
+ */
+
+#pragma once
+#include <vector>
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <string_view>
+#include <cstddef>
+
+namespace csv {
+    // Custom error class for CSV parsing errors
+    class Error : public std::exception {
+    public:
+        Error(const std::string& msg) : _msg(msg) {}
+        const char* what() const noexcept { return _msg.c_str(); }
+    private:
+        std::string _msg;
+    };
+
+    // Class representing a row in the CSV. The header is shared by reference with
+    // the parser or reader that produced the row, which must outlive it.
+    class Row {
+    public:
+        Row(const std::vector<std::string>& header);
+        ~Row();
+        unsigned int size() const;
+        void push(const std::string&);
+        void clear();
+        bool set(const std::string&, const std::string&);
+        const std::string& operator[](unsigned int) const;
+        const std::string& operator[](const std::string& valuePosition) const;
+        friend std::ostream& operator<<(std::ostream& os, const Row& row);
+        friend std::ofstream& operator<<(std::ofstream& os, const Row& row);
+    private:
+        const std::vector<std::string>* _header;
+        std::vector<std::string> _values;
+    };
+
+    // Kernels that find the separators outside quotes in a line. Best is the one
+    // picked for this CPU at startup, which every reader uses; the others can be
+    // asked for by name so tests and benchmarks can compare them.
+    enum class ScanKernel {
+        Best,
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    // Whether a kernel can run on this machine
+    bool scanKernelSupported(ScanKernel kernel);
+
+    // Split one line into fields with the given kernel, as the readers do; the fields
+    // are views into line. Throws Error if the kernel is not supported.
+    void splitFields(std::string_view line, char sep, std::vector<std::string_view>& fields, ScanKernel kernel = ScanKernel::Best);
+
+    // Enum for specifying the data source type
+    enum class DataType {
+        eFILE = 0,
+        ePURE = 1
+    };
+
+    // Main parser class
+    class Parser {
+    public:
+        Parser(const std::string&, const DataType& type = DataType::eFILE, char sep = ',');
+        ~Parser();
+        Row& getRow(unsigned int row) const;
+        unsigned int rowCount() const;
+        unsigned int columnCount() const;
+        std::vector<std::string> getHeader() const;
+        const std::string getHeaderElement(unsigned int pos) const;
+        const std::string& getFileName() const;
+        bool deleteRow(unsigned int row);
+        bool addRow(unsigned int pos, const std::vector<std::string>&);
+        void sync() const;
+        Row& operator[](unsigned int row) const;
+    private:
+        void parseHeader();
+        void parseContent();
+        std::string _file;
+        const DataType _type;
+        const char _sep;
+        std::vector<std::string> _originalFile;
+        std::vector<std::string> _header;
+        std::vector<Row*> _content;
+    };
+
+    // Streaming reader. Reads the file through a fixed-size buffer and parses one
+    // row per call to next(), reusing the caller's Row.
+    class Reader {
+    public:
+        Reader(const std::string& file, char sep = ',', size_t bufferSize = 64 * 1024);
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+        bool next(Row& row);
+        const std::vector<std::string>& getHeader() const;
+        unsigned int columnCount() const;
+        unsigned long lineNumber() const;
+        const std::string& getFileName() const;
+    private:
+        bool readLine(std::string& line);
+        std::string _file;
+        std::ifstream _stream;
+        const char _sep;
+        std::vector<char> _buffer;
+        size_t _pos;
+        size_t _end;
+        std::string _line;
+        unsigned long _lineNumber;
+        std::vector<std::string> _header;
+    };
+
+    // Read-only memory mapping of a whole file
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& file);
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        const char* data() const;
+        size_t size() const;
+    private:
+        const char* _data;
+        size_t _size;
+#ifdef _WIN32
+        void* _fileHandle;
+        void* _mappingHandle;
+#else
+        int _fd;
+#endif
+    };
+
+    // Row whose fields are views into the file mapped by a MappedReader. The
+    // views are valid only while the reader is alive.
+    class RowView {
+    public:
+        RowView(const std::vector<std::string>& header);
+        unsigned int size() const;
+        void push(std::string_view);
+        void clear();
+        std::string_view operator[](unsigned int) const;
+        std::string_view operator[](const std::string& valuePosition) const;
+    private:
+        const std::vector<std::string>* _header;
+        std::vector<std::string_view> _values;
+    };
+
+    // Reader over one byte range of a mapped file, produced by MappedReader::split.
+    // Ranges hold whole lines, so separate ranges can be parsed on separate threads.
+    // Line numbers count from the start of the range.
+    class RangeReader {
+    public:
+        RangeReader(const char* data, size_t begin, size_t end, char sep, const std::vector<std::string>& header);
+        bool next(RowView& row);
+        const std::vector<std::string>& getHeader() const;
+        unsigned long lineNumber() const;
+    private:
+        const char* _data;
+        size_t _pos;
+        size_t _end;
+        char _sep;
+        const std::vector<std::string>* _header;
+        unsigned long _lineNumber;
+    };
+
+    // Zero-copy reader over a memory-mapped file
+    class MappedReader {
+    public:
+        MappedReader(const std::string& file, char sep = ',');
+        MappedReader(const MappedReader&) = delete;
+        MappedReader& operator=(const MappedReader&) = delete;
+        bool next(RowView& row);
+        std::vector<RangeReader> split(size_t chunkBytes) const;
+        const std::vector<std::string>& getHeader() const;
+        unsigned int columnCount() const;
+        unsigned long lineNumber() const;
+        const std::string& getFileName() const;
+    private:
+        bool readLine(std::string_view& line);
+        std::string _file;
+        MappedFile _map;
+        const char _sep;
+        size_t _pos;
+        unsigned long _lineNumber;
+        std::vector<std::string> _header;
+    };
+}
@@ -0,0 +1,164 @@
+/*
+ * File: ConnectionPool.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file implements the ConnectionPool class, the read-only SQLite connections
+ * used for database reads, and the connection settings shared with the writer.
+ *
+ * Dependencies:
+ * - sqlite3 for database operations
+ * - StatementCache for per-connection prepared statements
+ *
+ */
+
+#include "ConnectionPool.h"
+#include <stdexcept>
+
+// How long a connection waits on a lock held by another connection before giving up
+static const int busyTimeoutMillis = 5000;
+
+ConnectionPool::ConnectionPool() {}
+
+ConnectionPool::~ConnectionPool() {
+    Close();
+}
+
+// Apply the shared connection settings
+void ConnectionPool::Configure(sqlite3* db, bool writer) {
+    // Wait for a busy database instead of failing at once with SQLITE_BUSY
+    sqlite3_busy_timeout(db, busyTimeoutMillis);
+
+    // WAL lets readers run alongside the writer; NORMAL only syncs at checkpoints,
+    // which is safe in WAL mode (a power loss can drop the last commits, never corrupt)
+    const char* writerPragmas =
+        "PRAGMA journal_mode = WAL;"
+        "PRAGMA synchronous = NORMAL;";
+
+    // Memory-map up to 256 MiB of the file and keep up to 16 MiB of pages per connection
+    const char* sharedPragmas =
+        "PRAGMA mmap_size = 268435456;"
+        "PRAGMA cache_size = -16384;"
+        "PRAGMA temp_store = MEMORY;";
+
+    const char* readerPragmas = "PRAGMA query_only = ON;";
+
+    for (const char* pragmas : { writer ? writerPragmas : readerPragmas, sharedPragmas }) {
+        char* errMsg = nullptr;
+        if (sqlite3_exec(db, pragmas, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+            std::string error = "Failed to configure connection: " + std::string(errMsg ? errMsg : sqlite3_errmsg(db));
+            sqlite3_free(errMsg);
+            throw std::runtime_error(error);
+        }
+    }
+}
+
+// Open count read-only connections to the database at path
+void ConnectionPool::Open(const std::string& path, size_t count) {
+    Close();
+    if (count == 0) {
+        count = 1;
+    }
+
+    try {
+        for (size_t i = 0; i < count; i++) {
+            std::unique_ptr<Connection> connection(new Connection());
+
+            // Each connection is only ever used by the thread holding its lease
+            int rc = sqlite3_open_v2(path.c_str(), &connection->db, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr);
+            if (rc != SQLITE_OK) {
+                std::string error = "Can't open read connection: " + std::string(sqlite3_errmsg(connection->db));
+                sqlite3_close(connection->db);
+                throw std::runtime_error(error);
+            }
+
+            connections.push_back(std::move(connection));
+            Configure(connections.back()->db, false);
+            connections.back()->statements.Prepare(connections.back()->db);
+            idle.push_back(connections.back().get());
+        }
+    }
+    catch (...) {
+        Close();
+        throw;
+    }
+}
+
+// Close every connection
+void ConnectionPool::Close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (std::unique_ptr<Connection>& connection : connections) {
+        // Statements must be finalized before the connection can close
+        connection->statements.Finalize();
+        sqlite3_close(connection->db);
+    }
+    connections.clear();
+    idle.clear();
+}
+
+// Lease a connection, waiting for one to become free if all are in use
+ConnectionPool::Lease ConnectionPool::Acquire() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (connections.empty()) {
+        throw std::runtime_error("Connection pool is not open");
+    }
+    available.wait(lock, [this]() { return !idle.empty(); });
+
+    Connection* connection = idle.back();
+    idle.pop_back();
+    return Lease(this, connection);
+}
+
+// Put a leased connection back and wake one waiting thread
+void ConnectionPool::release(Connection* connection) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        idle.push_back(connection);
+    }
+    available.notify_one();
+}
+
+// Number of connections in the pool
+size_t ConnectionPool::Size() const {
+    return connections.size();
+}
+
+// Timing counters for every statement, summed over the pool's connections
+std::vector<StatementCache::Timing> ConnectionPool::Timings() const {
+    std::vector<StatementCache::Timing> totals;
+    for (const std::unique_ptr<Connection>& connection : connections) {
+        std::vector<StatementCache::Timing> timings = connection->statements.Timings();
+        if (totals.empty()) {
+            totals = timings;
+            continue;
+        }
+        for (size_t i = 0; i < timings.size(); i++) {
+            totals[i].prepareNanos += timings[i].prepareNanos;
+            totals[i].executions += timings[i].executions;
+            totals[i].steps += timings[i].steps;
+            totals[i].stepNanos += timings[i].stepNanos;
+        }
+    }
+    return totals;
+}
+
+/*
+** LEASE
+*/
+
+ConnectionPool::Lease::Lease(ConnectionPool* aPool, Connection* aConnection)
+    : pool(aPool), connection(aConnection) {}
+
+ConnectionPool::Lease::Lease(Lease&& other) noexcept
+    : pool(other.pool), connection(other.connection) {
+    other.connection = nullptr;
+}
+
+ConnectionPool::Lease::~Lease() {
+    if (connection) {
+        pool->release(connection);
+    }
+}
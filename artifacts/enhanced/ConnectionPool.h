@@ -0,0 +1,95 @@
+/*
+ * File: ConnectionPool.h
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file defines the ConnectionPool class, a fixed set of read-only SQLite
+ * connections shared by the request threads. Each connection has its own
+ * StatementCache, and a connection is leased to one thread at a time, so reads
+ * from different threads run in parallel instead of queueing on the single
+ * writer connection. With the database in WAL mode, readers see the last
+ * committed state and never wait for the writer or hold it up.
+ *
+ * The class also holds the connection settings (journal mode, synchronous level,
+ * memory map and cache sizes, busy timeout) so the writer and the readers are
+ * configured in one place.
+ *
+ * Dependencies:
+ * - sqlite3 for database operations
+ * - StatementCache for per-connection prepared statements
+ *
+ */
+
+#pragma once
+#include <sqlite3.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include "StatementCache.h"
+
+class ConnectionPool {
+private:
+    struct Connection {
+        sqlite3* db;
+        StatementCache statements;
+
+        Connection() : db(nullptr) {}
+    };
+
+    std::vector<std::unique_ptr<Connection>> connections;
+    std::vector<Connection*> idle;
+    std::mutex mutex;
+    std::condition_variable available;
+
+    // Put a leased connection back and wake one waiting thread
+    void release(Connection* connection);
+
+public:
+    // Exclusive use of one read connection; returned to the pool on destruction
+    class Lease {
+    private:
+        ConnectionPool* pool;
+        Connection* connection;
+
+    public:
+        Lease(ConnectionPool* aPool, Connection* aConnection);
+        Lease(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease();
+
+        sqlite3* db() const { return connection->db; }
+        StatementCache& statements() const { return connection->statements; }
+    };
+
+    ConnectionPool();
+    ~ConnectionPool();
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    // Open count read-only connections to the database at path. The schema must
+    // already exist, since every statement is compiled here.
+    void Open(const std::string& path, size_t count);
+
+    // Close every connection; no lease may be outstanding
+    void Close();
+
+    // Lease a connection, waiting for one to become free if all are in use
+    Lease Acquire();
+
+    // Number of connections in the pool
+    size_t Size() const;
+
+    // Timing counters for every statement, summed over the pool's connections
+    std::vector<StatementCache::Timing> Timings() const;
+
+    // Apply the shared connection settings. Only the writer sets the journal mode
+    // and synchronous level; readers are additionally restricted to queries.
+    static void Configure(sqlite3* db, bool writer);
+};
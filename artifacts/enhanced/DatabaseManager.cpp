@@ -1,531 +1,1486 @@
-/*
- * File: DatabaseManager.cpp
- * Author: Thomas Gallegos
- * Email: N/A
- * Date: July 23, 2024
- * Version: 1.0
- *
- * Purpose:
- * This file implements the DatabaseManager class, handling all database operations
- * for the Bid Management System. It includes CRUD operations for bids and users,
- * CSV import functionality, and MFA management.
- *
- * Dependencies:
- * - sqlite3 for database operations
- * - CSVparser for CSV file parsing
- * - LinkedList for in-memory bid storage
- * - OpenSSL for password hashing
- *
- */
-
-#include "DatabaseManager.h"
-#include "Utils.h"
-#include <stdexcept>
-#include <vector>
-#include <cstring>
-#include <openssl/sha.h>
-
-DatabaseManager::DatabaseManager() : db(nullptr) {}
-
-DatabaseManager::~DatabaseManager() {
-    if (db) {
-        sqlite3_close(db);
-    }
-}
-
-void DatabaseManager::init() {
-    // Open the SQLite database
-    int rc = sqlite3_open("bids.db", &db);
-    if (rc) {
-        throw std::runtime_error("Can't open database: " + std::string(sqlite3_errmsg(db)));
-    }
-
-    // SQL to create the bids table
-    const char* sql = "CREATE TABLE IF NOT EXISTS bids ("
-        "auction_title TEXT,"
-        "auction_id TEXT PRIMARY KEY,"
-        "department TEXT,"
-        "close_date TEXT,"
-        "winning_bid REAL,"
-        "cc_fee REAL,"
-        "fee_percent REAL,"
-        "auction_fee_subtotal REAL,"
-        "auction_fee_total REAL,"
-        "pay_status TEXT,"
-        "paid_date TEXT,"
-        "asset_number TEXT,"
-        "inventory_id TEXT,"
-        "decal_vehicle_id TEXT,"
-        "vtr_number TEXT,"
-        "receipt_number TEXT,"
-        "cap REAL,"
-        "expenses REAL,"
-        "net_sales REAL,"
-        "fund TEXT,"
-        "business_unit TEXT"
-        ");";
-
-    // SQL to create the users table
-    const char* sql_users = "CREATE TABLE IF NOT EXISTS users ("
-        "username TEXT PRIMARY KEY,"
-        "password_hash TEXT,"
-        "totp_secret TEXT,"
-        "mfa_enabled INTEGER DEFAULT 0"
-        ");";
-
-    char* errMsg = nullptr;
-    rc = sqlite3_exec(db, sql, nullptr, nullptr, &errMsg);
-
-    if (rc != SQLITE_OK) {
-        std::string error = "SQL error: " + std::string(errMsg);
-        sqlite3_free(errMsg);
-        throw std::runtime_error(error);
-    }
-
-    // Load existing bids into the LinkedList
-    loadBidsIntoMemory();
-}
-
-// Load bids from the database into memory
-void DatabaseManager::loadBidsIntoMemory() {
-    const char* sql = "SELECT * FROM bids;";
-    sqlite3_stmt* stmt;
-
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare statement: " + std::string(sqlite3_errmsg(db)));
-    }
-
-    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
-        Bid bid;
-        // Populate bid object from database row
-        bid.auctionTitle = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        bid.auctionId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        bid.department = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        bid.closeDate = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        bid.winningBid = sqlite3_column_double(stmt, 4);
-        bid.ccFee = sqlite3_column_double(stmt, 5);
-        bid.feePercent = sqlite3_column_double(stmt, 6);
-        bid.auctionFeeSubtotal = sqlite3_column_double(stmt, 7);
-        bid.auctionFeeTotal = sqlite3_column_double(stmt, 8);
-        bid.payStatus = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 9));
-        bid.paidDate = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 10));
-        bid.assetNumber = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 11));
-        bid.inventoryId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 12));
-        bid.decalVehicleId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 13));
-        bid.vtrNumber = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 14));
-        bid.receiptNumber = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 15));
-        bid.cap = sqlite3_column_double(stmt, 16);
-        bid.expenses = sqlite3_column_double(stmt, 17);
-        bid.netSales = sqlite3_column_double(stmt, 18);
-        bid.fund = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 19));
-        bid.businessUnit = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 20));
-
-        bidList.Append(bid);
-    }
-
-    sqlite3_finalize(stmt);
-}
-
-// Add a new bid to the database and in-memory list
-void DatabaseManager::addBid(const Bid& bid) {
-    const char* sql = "INSERT INTO bids (auction_title, auction_id, department, close_date, winning_bid, cc_fee, fee_percent, auction_fee_subtotal, auction_fee_total, pay_status, paid_date, asset_number, inventory_id, decal_vehicle_id, vtr_number, receipt_number, cap, expenses, net_sales, fund, business_unit) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);";
-    sqlite3_stmt* stmt;
-
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare statement: " + std::string(sqlite3_errmsg(db)));
-    }
-
-    // Bind values to the prepared statement
-    sqlite3_bind_text(stmt, 1, bid.auctionTitle.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 2, bid.auctionId.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 3, bid.department.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 4, bid.closeDate.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_double(stmt, 5, bid.winningBid);
-    sqlite3_bind_double(stmt, 6, bid.ccFee);
-    sqlite3_bind_double(stmt, 7, bid.feePercent);
-    sqlite3_bind_double(stmt, 8, bid.auctionFeeSubtotal);
-    sqlite3_bind_double(stmt, 9, bid.auctionFeeTotal);
-    sqlite3_bind_text(stmt, 10, bid.payStatus.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 11, bid.paidDate.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 12, bid.assetNumber.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 13, bid.inventoryId.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 14, bid.decalVehicleId.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 15, bid.vtrNumber.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 16, bid.receiptNumber.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_double(stmt, 17, bid.cap);
-    sqlite3_bind_double(stmt, 18, bid.expenses);
-    sqlite3_bind_double(stmt, 19, bid.netSales);
-    sqlite3_bind_text(stmt, 20, bid.fund.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 21, bid.businessUnit.c_str(), -1, SQLITE_STATIC);
-
-    rc = sqlite3_step(stmt);
-    if (rc != SQLITE_DONE) {
-        sqlite3_finalize(stmt);
-        throw std::runtime_error("Failed to insert bid: " + std::string(sqlite3_errmsg(db)));
-    }
-
-    sqlite3_finalize(stmt);
-
-    // Also add to in-memory list
-    bidList.Append(bid);
-}
-
-// Retrieve a bid by its auction ID
-Bid DatabaseManager::getBid(const std::string& auctionId) {
-    // First, try to find the bid in the in-memory list
-    Bid bid = bidList.Search(auctionId);
-    if (!bid.auctionId.empty()) {
-        return bid;
-    }
-
-    // If not found in memory, search in the database
-    const char* sql = "SELECT * FROM bids WHERE auction_id = ?;";
-    sqlite3_stmt* stmt;
-
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare statement: " + std::string(sqlite3_errmsg(db)));
-    }
-
-    sqlite3_bind_text(stmt, 1, auctionId.c_str(), -1, SQLITE_STATIC);
-
-    rc = sqlite3_step(stmt);
-    if (rc != SQLITE_ROW) {
-        sqlite3_finalize(stmt);
-        throw std::runtime_error("Bid not found");
-    }
-
-    // Populate bid object from database row
-    bid.auctionTitle = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-    bid.auctionId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-    bid.department = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-    bid.closeDate = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-    bid.winningBid = sqlite3_column_double(stmt, 4);
-    bid.ccFee = sqlite3_column_double(stmt, 5);
-    bid.feePercent = sqlite3_column_double(stmt, 6);
-    bid.auctionFeeSubtotal = sqlite3_column_double(stmt, 7);
-    bid.auctionFeeTotal = sqlite3_column_double(stmt, 8);
-    bid.payStatus = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 9));
-    bid.paidDate = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 10));
-    bid.assetNumber = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 11));
-    bid.inventoryId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 12));
-    bid.decalVehicleId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 13));
-    bid.vtrNumber = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 14));
-    bid.receiptNumber = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 15));
-    bid.cap = sqlite3_column_double(stmt, 16);
-    bid.expenses = sqlite3_column_double(stmt, 17);
-    bid.netSales = sqlite3_column_double(stmt, 18);
-    bid.fund = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 19));
-    bid.businessUnit = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 20));
-
-    sqlite3_finalize(stmt);
-
-    // Add to in-memory list for future quick access
-    bidList.Append(bid);
-
-    return bid;
-}
-
-// Get all bids from the in-memory list
-std::vector<Bid> DatabaseManager::getAllBids() {
-    return bidList.GetAllBids();
-}
-
-// Update an existing bid
-void DatabaseManager::updateBid(const Bid& bid) {
-    const char* sql = "UPDATE bids SET auction_title = ?, department = ?, close_date = ?, winning_bid = ?, cc_fee = ?, fee_percent = ?, auction_fee_subtotal = ?, auction_fee_total = ?, pay_status = ?, paid_date = ?, asset_number = ?, inventory_id = ?, decal_vehicle_id = ?, vtr_number = ?, receipt_number = ?, cap = ?, expenses = ?, net_sales = ?, fund = ?, business_unit = ? WHERE auction_id = ?;";
-    sqlite3_stmt* stmt;
-
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare statement: " + std::string(sqlite3_errmsg(db)));
-    }
-
-    // Bind values to the prepared statement
-    sqlite3_bind_text(stmt, 1, bid.auctionTitle.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 2, bid.department.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 3, bid.closeDate.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_double(stmt, 4, bid.winningBid);
-    sqlite3_bind_double(stmt, 5, bid.ccFee);
-    sqlite3_bind_double(stmt, 6, bid.feePercent);
-    sqlite3_bind_double(stmt, 7, bid.auctionFeeSubtotal);
-    sqlite3_bind_double(stmt, 8, bid.auctionFeeTotal);
-    sqlite3_bind_text(stmt, 9, bid.payStatus.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 10, bid.paidDate.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 11, bid.assetNumber.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 12, bid.inventoryId.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 13, bid.decalVehicleId.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 14, bid.vtrNumber.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 15, bid.receiptNumber.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_double(stmt, 16, bid.cap);
-    sqlite3_bind_double(stmt, 17, bid.expenses);
-    sqlite3_bind_double(stmt, 18, bid.netSales);
-    sqlite3_bind_text(stmt, 19, bid.fund.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 20, bid.businessUnit.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 21, bid.auctionId.c_str(), -1, SQLITE_STATIC);
-
-    rc = sqlite3_step(stmt);
-    if (rc != SQLITE_DONE) {
-        sqlite3_finalize(stmt);
-        throw std::runtime_error("Failed to update bid: " + std::string(sqlite3_errmsg(db)));
-    }
-
-    sqlite3_finalize(stmt);
-
-    // Update in-memory list
-    bidList.Remove(bid.auctionId);
-    bidList.Append(bid);
-}
-
-// Delete a bid by its auction ID
-void DatabaseManager::deleteBid(const std::string& auctionId) {
-    const char* sql = "DELETE FROM bids WHERE auction_id = ?;";
-    sqlite3_stmt* stmt;
-
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare statement: " + std::string(sqlite3_errmsg(db)));
-    }
-
-    sqlite3_bind_text(stmt, 1, auctionId.c_str(), -1, SQLITE_STATIC);
-
-    rc = sqlite3_step(stmt);
-    if (rc != SQLITE_DONE) {
-        sqlite3_finalize(stmt);
-        throw std::runtime_error("Failed to delete bid: " + std::string(sqlite3_errmsg(db)));
-    }
-
-    sqlite3_finalize(stmt);
-
-    // Remove from in-memory list
-    bidList.Remove(auctionId);
-}
-
-// Add a new user to the database
-void DatabaseManager::addUser(const User& user) {
-    const char* sql = "INSERT INTO users (username, password_hash) VALUES (?, ?);";
-    sqlite3_stmt* stmt;
-
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare statement: " + std::string(sqlite3_errmsg(db)));
-    }
-
-    sqlite3_bind_text(stmt, 1, user.username.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 2, user.passwordHash.c_str(), -1, SQLITE_STATIC);
-
-    rc = sqlite3_step(stmt);
-    if (rc != SQLITE_DONE) {
-        sqlite3_finalize(stmt);
-        throw std::runtime_error("Failed to insert user: " + std::string(sqlite3_errmsg(db)));
-    }
-
-    sqlite3_finalize(stmt);
-}
-
-// Retrieve a user by username
-User DatabaseManager::getUser(const std::string& username) {
-    const char* sql = "SELECT * FROM users WHERE username = ?;";
-    sqlite3_stmt* stmt;
-
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare statement: " + std::string(sqlite3_errmsg(db)));
-    }
-
-    sqlite3_bind_text(stmt, 1, username.c_str(), -1, SQLITE_STATIC);
-
-    rc = sqlite3_step(stmt);
-    if (rc != SQLITE_ROW) {
-        sqlite3_finalize(stmt);
-        throw std::runtime_error("User not found");
-    }
-
-    User user;
-    user.username = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-    user.passwordHash = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-
-    sqlite3_finalize(stmt);
-    return user;
-}
-
-// Validate user credentials
-bool DatabaseManager::validateUser(const std::string& username, const std::string& password) {
-    try {
-        User user = getUser(username);
-        return user.passwordHash == hashPassword(password);
-    }
-    catch (const std::runtime_error&) {
-        return false;
-    }
-}
-
-// Import bids from a CSV file
-void DatabaseManager::importFromCSV(const std::string& filename) {
-    std::cout << "Attempting to import CSV from: " << filename << std::endl;
-    try {
-        csv::Parser parser(filename);
-        std::cout << "Successfully opened CSV file. Row count: " << parser.rowCount() << std::endl;
-
-        // Skip the header row
-        for (unsigned int i = 1; i < parser.rowCount(); i++) {
-            try {
-                csv::Row& row = parser[i];
-
-                Bid bid;
-                // Populate bid object from CSV row
-                bid.auctionTitle = row[0];
-                bid.auctionId = row[1];
-                bid.department = row[2];
-                bid.closeDate = row[3];
-
-                // Add error checking for numeric conversions
-                try {
-                    bid.winningBid = std::stod(row[4].empty() ? "0" : row[4].substr(row[4].find_first_not_of(" $")));
-                    bid.ccFee = std::stod(row[5].empty() ? "0" : row[5].substr(row[5].find_first_not_of(" $")));
-                    bid.feePercent = std::stod(row[6].empty() ? "0" : row[6]);
-                    bid.auctionFeeSubtotal = std::stod(row[7].empty() ? "0" : row[7].substr(row[7].find_first_not_of(" $")));
-                    bid.auctionFeeTotal = std::stod(row[8].empty() ? "0" : row[8].substr(row[8].find_first_not_of(" $")));
-                }
-                catch (const std::exception& e) {
-                    std::cerr << "Error converting numeric values in row " << i << ": " << e.what() << std::endl;
-                    continue; // Skip this row and move to the next
-                }
-
-                bid.payStatus = row[9];
-                bid.paidDate = row[10];
-                bid.assetNumber = row[11];
-                bid.inventoryId = row[12];
-                bid.decalVehicleId = row[13];
-                bid.vtrNumber = row[14];
-                bid.receiptNumber = row[15];
-
-                // Add error checking for cap conversion
-                try {
-                    std::string capStr = row[16];
-                    capStr.erase(std::remove_if(capStr.begin(), capStr.end(), [](char c) { return c == '$' || c == ',' || std::isspace(c); }), capStr.end());
-                    bid.cap = std::stod(capStr.empty() ? "0" : capStr);
-                }
-                catch (const std::exception& e) {
-                    std::cerr << "Error converting cap value in row " << i << ": " << e.what() << std::endl;
-                    continue; // Skip this row and move to the next
-                }
-
-                // Add error checking for expenses and netSales conversions
-                try {
-                    bid.expenses = std::stod(row[17].empty() ? "0" : row[17].substr(row[17].find_first_not_of(" $")));
-                    bid.netSales = std::stod(row[18].empty() ? "0" : row[18].substr(row[18].find_first_not_of(" $")));
-                }
-                catch (const std::exception& e) {
-                    std::cerr << "Error converting expenses or netSales in row " << i << ": " << e.what() << std::endl;
-                    continue; // Skip this row and move to the next
-                }
-
-                bid.fund = row[19];
-                bid.businessUnit = row[20];
-
-                addBid(bid);
-                std::cout << "Imported bid: " << bid.auctionId << std::endl;
-            }
-            catch (const std::exception& e) {
-                std::cerr << "Error processing row " << i << ": " << e.what() << std::endl;
-            }
-        }
-        std::cout << "CSV import completed successfully" << std::endl;
-    }
-    catch (csv::Error& e) {
-        std::cerr << "CSV Parser error: " << e.what() << std::endl;
-        throw std::runtime_error(std::string("CSV Parser error: ") + e.what());
-    }
-    catch (std::exception& e) {
-        std::cerr << "Error during CSV import: " << e.what() << std::endl;
-        throw;
-    }
-}
-
-// New methods using LinkedList functionalities
-// Get sorted bids using a custom comparator
-std::vector<Bid> DatabaseManager::getSortedBids(bool (*comparator)(const Bid&, const Bid&)) {
-    LinkedList sortedList = bidList; // Create a copy of the list
-    sortedList.Sort(comparator);
-    return sortedList.GetAllBids();
-}
-
-// Perform binary search on the bid list
-Bid DatabaseManager::binarySearchBid(const std::string& auctionId) {
-    return bidList.BinarySearch(auctionId);
-
-}
-
-
-// Enable Multi-Factor Authentication for a user
-void DatabaseManager::enableMFA(const std::string& username, const std::string& totpSecret) {
-    const char* sql = "UPDATE users SET totp_secret = ?, mfa_enabled = 1 WHERE username = ?;";
-    sqlite3_stmt* stmt;
-
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare statement: " + std::string(sqlite3_errmsg(db)));
-    }
-
-    sqlite3_bind_text(stmt, 1, totpSecret.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 2, username.c_str(), -1, SQLITE_STATIC);
-
-    rc = sqlite3_step(stmt);
-    if (rc != SQLITE_DONE) {
-        sqlite3_finalize(stmt);
-        throw std::runtime_error("Failed to enable MFA: " + std::string(sqlite3_errmsg(db)));
-    }
-
-    sqlite3_finalize(stmt);
-}
-
-// Check if MFA is enabled for a user
-bool DatabaseManager::isMFAEnabled(const std::string& username) {
-    const char* sql = "SELECT mfa_enabled FROM users WHERE username = ?;";
-    sqlite3_stmt* stmt;
-
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare statement: " + std::string(sqlite3_errmsg(db)));
-    }
-
-    sqlite3_bind_text(stmt, 1, username.c_str(), -1, SQLITE_STATIC);
-
-    rc = sqlite3_step(stmt);
-    if (rc != SQLITE_ROW) {
-        sqlite3_finalize(stmt);
-        throw std::runtime_error("User not found");
-    }
-
-    bool mfaEnabled = sqlite3_column_int(stmt, 0) == 1;
-    sqlite3_finalize(stmt);
-
-    return mfaEnabled;
-}
-
-// Get the TOTP secret for a user
-std::string DatabaseManager::getTOTPSecret(const std::string& username) {
-    const char* sql = "SELECT totp_secret FROM users WHERE username = ?;";
-    sqlite3_stmt* stmt;
-
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare statement: " + std::string(sqlite3_errmsg(db)));
-    }
-
-    sqlite3_bind_text(stmt, 1, username.c_str(), -1, SQLITE_STATIC);
-
-    rc = sqlite3_step(stmt);
-    if (rc != SQLITE_ROW) {
-        sqlite3_finalize(stmt);
-        throw std::runtime_error("User not found");
-    }
-
-    std::string totpSecret = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-    sqlite3_finalize(stmt);
-
-    return totpSecret;
+/*
+ * File: DatabaseManager.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file implements the DatabaseManager class, handling all database operations
+ * for the Bid Management System. It includes CRUD operations for bids and users,
+ * CSV import functionality, and MFA management.
+ *
+ * Dependencies:
+ * - sqlite3 for database operations
+ * - CSVparser for CSV file parsing
+ * - BidCSVSchema to bind CSV columns to bid fields
+ * - LinkedList for in-memory bid storage
+ * - BidColumnStore for columnar analytics over the bids
+ * - StatementCache for prepared statements
+ * - ConnectionPool for the read-only connections
+ * - BidStoreFile for the binary copy of the bids used at startup
+ * - OpenSSL for password hashing
+ *
+ */
+
+#include "DatabaseManager.h"
+#include "Utils.h"
+#include "BidCSVSchema.h"
+#include "BidStoreFile.h"
+#include <stdexcept>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <openssl/sha.h>
+
+// Field covered by the title index
+static const std::string& auctionTitleOf(const Bid& bid) {
+    return bid.auctionTitle;
+}
+
+// Fields covered by the autocomplete indexes, in BidColumnStore::IdentifierColumn order
+static const PrefixIndex::Field identifierFields[BidColumnStore::IdentifierColumnCount] = {
+    [](const Bid& bid) -> const std::string& { return bid.auctionId; },
+    [](const Bid& bid) -> const std::string& { return bid.assetNumber; },
+    [](const Bid& bid) -> const std::string& { return bid.receiptNumber; },
+    [](const Bid& bid) -> const std::string& { return bid.vtrNumber; }
+};
+
+DatabaseManager::BidIndexes::BidIndexes() : titles(auctionTitleOf) {
+    for (PrefixIndex::Field field : identifierFields) {
+        identifiers.emplace_back(field);
+    }
+}
+
+void DatabaseManager::BidIndexes::Add(const Bid& bid) {
+    titles.Add(bid);
+    for (PrefixIndex& index : identifiers) {
+        index.Add(bid);
+    }
+    inventory.Add(bid);
+    columns.Append(bid);
+}
+
+void DatabaseManager::BidIndexes::Remove(const std::string& auctionId) {
+    titles.Remove(auctionId);
+    for (PrefixIndex& index : identifiers) {
+        index.Remove(auctionId);
+    }
+    inventory.Remove(auctionId);
+    columns.Remove(auctionId);
+}
+
+void DatabaseManager::BidIndexes::Build(const BidSnapshot& snapshot, bool withInventory) {
+    titles.Build(snapshot);
+    for (PrefixIndex& index : identifiers) {
+        index.Build(snapshot);
+    }
+    if (withInventory) {
+        inventory.Build(snapshot);
+    }
+
+    columns.Clear();
+    columns.Reserve(snapshot.size());
+    for (size_t row = 0; row < snapshot.size(); row++) {
+        columns.Append(snapshot[row]);
+    }
+}
+
+void DatabaseManager::BidIndexes::Swap(BidIndexes& other) {
+    titles.Swap(other.titles);
+    identifiers.swap(other.identifiers);
+    inventory.Swap(other.inventory);
+    std::swap(columns, other.columns);
+}
+
+DatabaseManager::DatabaseManager(const std::string& aDatabasePath, size_t readConnections)
+    : databasePath(aDatabasePath), readConnectionCount(readConnections), db(nullptr),
+      storePath(std::filesystem::path(aDatabasePath).replace_extension(".store").string()), savedGeneration(UINT64_MAX), memoryGeneration(0),
+      outsideChangeReported(false), stopStoreWriter(false),
+      warming(false), stopWarmup(false), warmupLoaded(0), warmupTotal(0), warmupNanos(0),
+      databaseSnapshotGeneration(UINT64_MAX) {}
+
+DatabaseManager::~DatabaseManager() {
+    // Abandon a warm-up that is still running; the database already has every change
+    if (warmupThread.joinable()) {
+        stopWarmup = true;
+        warmupThread.join();
+    }
+
+    // Stop the store writer and save any changes it has not written yet
+    if (storeWriter.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(storeWriterMutex);
+            stopStoreWriter = true;
+        }
+        storeWriterWake.notify_all();
+        storeWriter.join();
+
+        try {
+            saveStoreFile();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Failed to save bid store file: " << e.what() << std::endl;
+        }
+    }
+
+    // Statements must be finalized before the connection can close
+    readers.Close();
+    statements.Finalize();
+    if (db) {
+        sqlite3_close(db);
+    }
+}
+
+void DatabaseManager::init(bool lazyLoad) {
+    // Open the SQLite database; the writer switches it to WAL so readers can run alongside
+    int rc = sqlite3_open(databasePath.c_str(), &db);
+    if (rc) {
+        throw std::runtime_error("Can't open database: " + std::string(sqlite3_errmsg(db)));
+    }
+    ConnectionPool::Configure(db, true);
+
+    // SQL to create the bids table
+    const char* sql = "CREATE TABLE IF NOT EXISTS bids ("
+        "auction_title TEXT,"
+        "auction_id TEXT PRIMARY KEY,"
+        "department TEXT,"
+        "close_date TEXT,"
+        "winning_bid REAL,"
+        "cc_fee REAL,"
+        "fee_percent REAL,"
+        "auction_fee_subtotal REAL,"
+        "auction_fee_total REAL,"
+        "pay_status TEXT,"
+        "paid_date TEXT,"
+        "asset_number TEXT,"
+        "inventory_id TEXT,"
+        "decal_vehicle_id TEXT,"
+        "vtr_number TEXT,"
+        "receipt_number TEXT,"
+        "cap REAL,"
+        "expenses REAL,"
+        "net_sales REAL,"
+        "fund TEXT,"
+        "business_unit TEXT"
+        ");";
+
+    // SQL to create the users table
+    const char* sql_users = "CREATE TABLE IF NOT EXISTS users ("
+        "username TEXT PRIMARY KEY,"
+        "password_hash TEXT,"
+        "totp_secret TEXT,"
+        "mfa_enabled INTEGER DEFAULT 0"
+        ");";
+
+    // Change counter for the bids table, bumped by triggers on every insert, update
+    // and delete (including changes made outside this program). The bid store file
+    // records the value it was written at, so a stale file is never loaded.
+    const char* sql_generation =
+        "CREATE TABLE IF NOT EXISTS meta (key TEXT PRIMARY KEY, value INTEGER);"
+        "INSERT OR IGNORE INTO meta (key, value) VALUES ('generation', 0);"
+        "CREATE TRIGGER IF NOT EXISTS bids_generation_insert AFTER INSERT ON bids "
+        "BEGIN UPDATE meta SET value = value + 1 WHERE key = 'generation'; END;"
+        "CREATE TRIGGER IF NOT EXISTS bids_generation_update AFTER UPDATE ON bids "
+        "BEGIN UPDATE meta SET value = value + 1 WHERE key = 'generation'; END;"
+        "CREATE TRIGGER IF NOT EXISTS bids_generation_delete AFTER DELETE ON bids "
+        "BEGIN UPDATE meta SET value = value + 1 WHERE key = 'generation'; END;";
+
+    char* errMsg = nullptr;
+    for (const char* statement : { sql, sql_users, sql_generation }) {
+        rc = sqlite3_exec(db, statement, nullptr, nullptr, &errMsg);
+
+        if (rc != SQLITE_OK) {
+            std::string error = "SQL error: " + std::string(errMsg);
+            sqlite3_free(errMsg);
+            throw std::runtime_error(error);
+        }
+    }
+
+    // Compile every statement once; later calls only reset and rebind them
+    statements.Prepare(db);
+
+    // Open the read connections now that the schema exists
+    readers.Open(databasePath, readConnectionCount);
+
+    // In lazy mode, serve reads from the database until the background warm-up switches over
+    if (lazyLoad) {
+        warmupStart = std::chrono::steady_clock::now();
+        warming = true;
+        warmupThread = std::thread(&DatabaseManager::warmUp, this);
+        return;
+    }
+
+    // Load existing bids into the LinkedList, from the store file when it is current.
+    // The generation and the rows are read in one transaction so that they agree.
+    auto start = std::chrono::steady_clock::now();
+    uint64_t generation;
+    bool fromStore;
+    executeStatement(StatementCache::BeginTransaction);
+    try {
+        generation = readGeneration();
+        fromStore = loadStoreFile(generation);
+        if (!fromStore) {
+            loadBidsIntoMemory();
+        }
+        executeStatement(StatementCache::CommitTransaction);
+    }
+    catch (...) {
+        try {
+            executeStatement(StatementCache::RollbackTransaction);
+        }
+        catch (const std::exception&) {
+            // The original error is the one worth reporting
+        }
+        throw;
+    }
+    memoryGeneration = generation;
+    if (fromStore) {
+        savedGeneration = generation;
+    }
+    indexes.Build(*bidList.Snapshot(), !fromStore);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    warmupLoaded = warmupTotal = static_cast<size_t>(bidList.Size());
+    warmupNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    std::cout << "Loaded " << bidList.Size() << " bids from " << (fromStore ? "the bid store file" : "the database")
+        << " in " << std::chrono::duration<double>(elapsed).count() << " s" << std::endl;
+}
+
+// How far the background warm-up has got
+WarmupProgress DatabaseManager::getWarmupProgress() const {
+    WarmupProgress progress;
+    progress.ready = !warming;
+    progress.loaded = warmupLoaded;
+    progress.total = warmupTotal;
+    if (progress.ready) {
+        progress.seconds = warmupNanos / 1e9;
+    }
+    else {
+        progress.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - warmupStart).count();
+    }
+    return progress;
+}
+
+// Run a statement that returns no rows on the given connection
+static void runStatement(sqlite3* connection, StatementCache& cache, StatementCache::StatementId id) {
+    StatementCache::Handle stmt = cache.Acquire(id);
+    if (stmt.Step() != SQLITE_DONE) {
+        throw std::runtime_error("Failed to execute statement: " + std::string(sqlite3_errmsg(connection)));
+    }
+}
+
+// Value of the change counter as seen by the given connection
+static uint64_t queryGeneration(sqlite3* connection, StatementCache& cache) {
+    StatementCache::Handle stmt = cache.Acquire(StatementCache::SelectGeneration);
+    if (stmt.Step() != SQLITE_ROW) {
+        throw std::runtime_error("Failed to read database generation: " + std::string(sqlite3_errmsg(connection)));
+    }
+    return static_cast<uint64_t>(sqlite3_column_int64(stmt.get(), 0));
+}
+
+// Read transaction on a pooled connection, so several queries see the same committed state
+class ReadTransaction {
+private:
+    const ConnectionPool::Lease& connection;
+
+public:
+    explicit ReadTransaction(const ConnectionPool::Lease& aConnection) : connection(aConnection) {
+        runStatement(connection.db(), connection.statements(), StatementCache::BeginTransaction);
+    }
+
+    ~ReadTransaction() {
+        try {
+            runStatement(connection.db(), connection.statements(), StatementCache::CommitTransaction);
+        }
+        catch (const std::exception&) {
+            // Ending a read transaction cannot lose data
+        }
+    }
+};
+
+// Current value of the database's change counter
+uint64_t DatabaseManager::readGeneration() {
+    return queryGeneration(db, statements);
+}
+
+// Load bids from the store file; false if it is missing, stale or corrupt
+bool DatabaseManager::loadStoreFile(uint64_t generation) {
+    std::string error;
+    bool loaded = BidStoreFile::Read(storePath, generation, [this](std::vector<Bid>& bids) {
+        bidList.AppendBatch(std::move(bids));
+    }, [this](std::string_view item, std::string_view auctionId) {
+        indexes.inventory.Insert(item, auctionId);
+    }, error);
+
+    if (!loaded) {
+        std::cout << "Bid store file not used (" << error << "); loading from the database" << std::endl;
+    }
+    return loaded;
+}
+
+// Save the in-memory bids to the store file if they changed since the last save
+void DatabaseManager::saveStoreFile() {
+    std::shared_ptr<const BidSnapshot> snapshot;
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(storeMutex);
+        if (warming) {
+            return;  // Nothing complete to save until warm-up switches over
+        }
+        generation = memoryGeneration;
+        if (generation == savedGeneration) {
+            return;
+        }
+
+        // A file stamped with our generation would be rejected at startup anyway, and one
+        // stamped with the database's would claim changes the in-memory bids do not have
+        if (readGeneration() != generation) {
+            if (!outsideChangeReported) {
+                std::cerr << "Bid store file not saved: the database was changed outside this process" << std::endl;
+                outsideChangeReported = true;
+            }
+            return;
+        }
+        snapshot = publishedSnapshot();
+    }
+
+    // Writing happens outside the lock; the snapshot cannot change underneath it
+    BidStoreFile::Write(storePath, *snapshot, generation);
+    savedGeneration = generation;
+}
+
+// Save the store file every interval on a background thread
+void DatabaseManager::startStoreWriter(std::chrono::seconds interval) {
+    if (storeWriter.joinable()) {
+        return;
+    }
+    stopStoreWriter = false;
+    storeWriter = std::thread([this, interval]() {
+        std::unique_lock<std::mutex> lock(storeWriterMutex);
+        while (!storeWriterWake.wait_for(lock, interval, [this]() { return stopStoreWriter; })) {
+            lock.unlock();
+            try {
+                saveStoreFile();
+            }
+            catch (const std::exception& e) {
+                std::cerr << "Failed to save bid store file: " << e.what() << std::endl;
+            }
+            lock.lock();
+        }
+    });
+}
+
+// Read a text column, treating NULL as an empty string
+static const char* columnText(sqlite3_stmt* stmt, int column) {
+    const unsigned char* text = sqlite3_column_text(stmt, column);
+    return text ? reinterpret_cast<const char*>(text) : "";
+}
+
+// Populate a bid object from the current row of a SELECT * FROM bids statement
+static Bid readBidRow(sqlite3_stmt* stmt) {
+    Bid bid;
+    bid.auctionTitle = columnText(stmt, 0);
+    bid.auctionId = columnText(stmt, 1);
+    bid.department = columnText(stmt, 2);
+    bid.closeDate = columnText(stmt, 3);
+    bid.winningBid = sqlite3_column_double(stmt, 4);
+    bid.ccFee = sqlite3_column_double(stmt, 5);
+    bid.feePercent = sqlite3_column_double(stmt, 6);
+    bid.auctionFeeSubtotal = sqlite3_column_double(stmt, 7);
+    bid.auctionFeeTotal = sqlite3_column_double(stmt, 8);
+    bid.payStatus = columnText(stmt, 9);
+    bid.paidDate = columnText(stmt, 10);
+    bid.assetNumber = columnText(stmt, 11);
+    bid.inventoryId = columnText(stmt, 12);
+    bid.decalVehicleId = columnText(stmt, 13);
+    bid.vtrNumber = columnText(stmt, 14);
+    bid.receiptNumber = columnText(stmt, 15);
+    bid.cap = sqlite3_column_double(stmt, 16);
+    bid.expenses = sqlite3_column_double(stmt, 17);
+    bid.netSales = sqlite3_column_double(stmt, 18);
+    bid.fund = columnText(stmt, 19);
+    bid.businessUnit = columnText(stmt, 20);
+    return bid;
+}
+
+// Bids read from the database before they are added to memory in one go
+static const size_t loadBatchSize = 65536;
+
+// Load bids from the database into memory
+void DatabaseManager::loadBidsIntoMemory() {
+    StatementCache::Handle stmt = statements.Acquire(StatementCache::SelectAllBids);
+
+    int rc;
+    std::vector<Bid> batch;
+    while ((rc = stmt.Step()) == SQLITE_ROW) {
+        batch.push_back(readBidRow(stmt.get()));
+        if (batch.size() == loadBatchSize) {
+            bidList.AppendBatch(std::move(batch));
+            batch = std::vector<Bid>();
+        }
+    }
+    bidList.AppendBatch(std::move(batch));
+
+    if (rc != SQLITE_DONE) {
+        throw std::runtime_error("Failed to load bids: " + std::string(sqlite3_errmsg(db)));
+    }
+}
+
+// Bids read from the database per page during warm-up. Pages are read on a pooled
+// read-only connection inside one ReadTransaction, without storeMutex, so writers are
+// never held up by them; the page size only bounds how much is staged per step and
+// how soon a stop request is noticed.
+static const int warmupPageSize = 10000;
+
+// Build the in-memory store in the background, then switch reads over to it.
+// Runs on warmupThread in lazy loading mode.
+void DatabaseManager::warmUp() {
+    LinkedList stagedList;
+    BidIndexes stagedIndexes;
+    bool fromStore = false;
+    uint64_t generation = 0;
+
+    auto stage = [&](std::vector<Bid>& bids) {
+        warmupLoaded += bids.size();
+        stagedList.AppendBatch(std::move(bids));
+    };
+    auto stageInventory = [&](std::string_view item, std::string_view auctionId) {
+        stagedIndexes.inventory.Insert(item, auctionId);
+    };
+
+    try {
+        // Everything is read in one transaction on a read connection, so the pages form a
+        // consistent picture of the table at one generation; writers are only held up
+        // while that generation is read
+        ConnectionPool::Lease connection = readers.Acquire();
+        std::unique_lock<std::mutex> writersHeld(storeMutex);
+        ReadTransaction transaction(connection);
+        generation = queryGeneration(connection.db(), connection.statements());
+
+        // Writers are held off while the generation is read, so each of their changes
+        // either is in it or is counted on top of it
+        memoryGeneration = generation;
+        writersHeld.unlock();
+        {
+            StatementCache::Handle count = connection.statements().Acquire(StatementCache::CountBids);
+            if (count.Step() != SQLITE_ROW) {
+                throw std::runtime_error("Failed to count bids: " + std::string(sqlite3_errmsg(connection.db())));
+            }
+            warmupTotal = static_cast<size_t>(sqlite3_column_int64(count.get(), 0));
+        }
+
+        // The store file holds the bids as of the generation just read; anything
+        // committed since then is in the pending log
+        std::string error;
+        fromStore = BidStoreFile::Read(storePath, generation, stage, stageInventory, error);
+        if (!fromStore) {
+            std::cout << "Bid store file not used (" << error << "); warming up from the database" << std::endl;
+
+            // Page through the table by rowid; changes committed since the transaction
+            // began are in the pending log
+            sqlite3_int64 lastRowId = 0;
+            for (;;) {
+                if (stopWarmup) {
+                    return;
+                }
+
+                std::vector<Bid> page;
+                {
+                    StatementCache::Handle stmt = connection.statements().Acquire(StatementCache::SelectBidPage);
+                    stmt.BindInt64(1, lastRowId);
+                    stmt.BindInt(2, warmupPageSize);
+
+                    int rc;
+                    while ((rc = stmt.Step()) == SQLITE_ROW) {
+                        page.push_back(readBidRow(stmt.get()));
+                        lastRowId = sqlite3_column_int64(stmt.get(), 21);
+                    }
+                    if (rc != SQLITE_DONE) {
+                        throw std::runtime_error("Failed to load bids: " + std::string(sqlite3_errmsg(connection.db())));
+                    }
+                }
+
+                if (page.empty()) {
+                    break;
+                }
+                stage(page);
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        // Keep serving from the database; stop logging changes nobody will replay
+        std::cerr << "Bid warm-up failed: " << e.what() << "; reads stay on the database" << std::endl;
+        std::lock_guard<std::mutex> lock(storeMutex);
+        stopWarmup = true;
+        pendingWrites.clear();
+        pendingWrites.shrink_to_fit();
+        return;
+    }
+
+    // Index the staged bids before taking the lock; writers are not held up by it
+    stagedIndexes.Build(*stagedList.Snapshot(), !fromStore);
+
+    // Replay the changes committed during warm-up, then swap the staged store in.
+    // Replaying is idempotent, so a change the staged store already has is harmless.
+    std::lock_guard<std::mutex> lock(storeMutex);
+    for (const PendingWrite& write : pendingWrites) {
+        stagedList.Remove(write.bid.auctionId);
+        stagedIndexes.Remove(write.bid.auctionId);
+        if (!write.remove) {
+            stagedList.Append(write.bid);
+            stagedIndexes.Add(write.bid);
+        }
+    }
+    size_t replayed = pendingWrites.size();
+    pendingWrites.clear();
+    pendingWrites.shrink_to_fit();
+
+    {
+        std::unique_lock<std::shared_mutex> indexLock(indexMutex);
+        bidList.Swap(stagedList);
+        indexes.Swap(stagedIndexes);
+        retireSnapshot();
+    }
+    {
+        std::lock_guard<std::mutex> snapshotLock(databaseSnapshotMutex);
+        databaseSnapshot.reset();
+    }
+    if (fromStore) {
+        savedGeneration = generation;
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - warmupStart;
+    warmupNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    warmupLoaded = static_cast<size_t>(bidList.Size());
+    warming = false;
+
+    std::cout << "Warmed up " << bidList.Size() << " bids from " << (fromStore ? "the bid store file" : "the database")
+        << " in " << std::chrono::duration<double>(elapsed).count() << " s (" << replayed
+        << " changes replayed)" << std::endl;
+}
+
+// Apply a committed change to the in-memory store, or log it while warming
+void DatabaseManager::storeUpsert(const Bid& bid) {
+    if (warming) {
+        if (!stopWarmup) {
+            pendingWrites.push_back(PendingWrite{ false, bid });
+        }
+        return;
+    }
+    std::unique_lock<std::shared_mutex> indexLock(indexMutex);
+    bidList.Remove(bid.auctionId);
+    bidList.Append(bid);
+    indexes.Add(bid);
+    retireSnapshot();
+}
+
+void DatabaseManager::storeRemove(const std::string& auctionId) {
+    if (warming) {
+        if (!stopWarmup) {
+            Bid bid;
+            bid.auctionId = auctionId;
+            pendingWrites.push_back(PendingWrite{ true, std::move(bid) });
+        }
+        return;
+    }
+    std::unique_lock<std::shared_mutex> indexLock(indexMutex);
+    bidList.Remove(auctionId);
+    indexes.Remove(auctionId);
+    retireSnapshot();
+}
+
+// Drop the published snapshot after a change. Callers hold indexMutex exclusively, so
+// a listing being built from the old contents is published before this clears it.
+void DatabaseManager::retireSnapshot() {
+    std::atomic_store(&published, std::shared_ptr<const BidSnapshot>());
+}
+
+// The published snapshot of bidList, built first if a change retired it. Between
+// changes this is one atomic load; after one, the first caller walks the list once
+// and later callers share what it built.
+std::shared_ptr<const BidSnapshot> DatabaseManager::publishedSnapshot() {
+    std::shared_ptr<const BidSnapshot> snapshot = std::atomic_load(&published);
+    if (snapshot) {
+        return snapshot;
+    }
+
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    snapshot = std::atomic_load(&published);
+    if (!snapshot) {
+        // Published while the shared lock is held, so no change can slip in between
+        std::shared_lock<std::shared_mutex> indexLock(indexMutex);
+        snapshot = bidList.Snapshot();
+        std::atomic_store(&published, snapshot);
+    }
+    return snapshot;
+}
+
+// Every bid read straight from the database, for listings while warming. The
+// result is kept until the database generation changes.
+std::shared_ptr<const BidSnapshot> DatabaseManager::readSnapshotFromDatabase() {
+    ConnectionPool::Lease connection = readers.Acquire();
+    ReadTransaction transaction(connection);
+
+    uint64_t generation = queryGeneration(connection.db(), connection.statements());
+    {
+        std::lock_guard<std::mutex> lock(databaseSnapshotMutex);
+        if (databaseSnapshot && generation == databaseSnapshotGeneration) {
+            return databaseSnapshot;
+        }
+    }
+
+    StatementCache::Handle stmt = connection.statements().Acquire(StatementCache::SelectAllBids);
+    std::vector<BidPtr> rows;
+    int rc;
+    while ((rc = stmt.Step()) == SQLITE_ROW) {
+        rows.push_back(std::make_shared<const Bid>(readBidRow(stmt.get())));
+    }
+    if (rc != SQLITE_DONE) {
+        throw std::runtime_error("Failed to read bids: " + std::string(sqlite3_errmsg(connection.db())));
+    }
+
+    std::shared_ptr<const BidSnapshot> snapshot = std::make_shared<const BidSnapshot>(std::move(rows));
+    std::lock_guard<std::mutex> lock(databaseSnapshotMutex);
+    if (!databaseSnapshot || generation > databaseSnapshotGeneration) {
+        databaseSnapshot = snapshot;
+        databaseSnapshotGeneration = generation;
+    }
+    return snapshot;
+}
+
+// Bind a bid to the cached INSERT and run it, returning the sqlite3_step result
+int DatabaseManager::insertBidRow(const Bid& bid) {
+    StatementCache::Handle stmt = statements.Acquire(StatementCache::InsertBid);
+
+    // Bind values to the prepared statement
+    stmt.BindText(1, bid.auctionTitle);
+    stmt.BindText(2, bid.auctionId);
+    stmt.BindText(3, bid.department);
+    stmt.BindText(4, bid.closeDate);
+    stmt.BindDouble(5, bid.winningBid);
+    stmt.BindDouble(6, bid.ccFee);
+    stmt.BindDouble(7, bid.feePercent);
+    stmt.BindDouble(8, bid.auctionFeeSubtotal);
+    stmt.BindDouble(9, bid.auctionFeeTotal);
+    stmt.BindText(10, bid.payStatus);
+    stmt.BindText(11, bid.paidDate);
+    stmt.BindText(12, bid.assetNumber);
+    stmt.BindText(13, bid.inventoryId);
+    stmt.BindText(14, bid.decalVehicleId);
+    stmt.BindText(15, bid.vtrNumber);
+    stmt.BindText(16, bid.receiptNumber);
+    stmt.BindDouble(17, bid.cap);
+    stmt.BindDouble(18, bid.expenses);
+    stmt.BindDouble(19, bid.netSales);
+    stmt.BindText(20, bid.fund);
+    stmt.BindText(21, bid.businessUnit);
+
+    return stmt.Step();
+}
+
+// Add a new bid to the database and in-memory list
+void DatabaseManager::addBid(const Bid& bid) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    if (insertBidRow(bid) != SQLITE_DONE) {
+        throw std::runtime_error("Failed to insert bid: " + std::string(sqlite3_errmsg(db)));
+    }
+    memoryGeneration += static_cast<uint64_t>(sqlite3_changes(db));
+
+    // Also add to in-memory list and column store
+    storeUpsert(bid);
+}
+
+// Retrieve a bid by its auction ID
+Bid DatabaseManager::getBid(const std::string& auctionId) {
+    // First, try the in-memory list (still empty while warming up). This is a hash
+    // lookup under a shared lock, so it waits at most for one in-memory update.
+    if (!warming) {
+        BidPtr found;
+        {
+            std::shared_lock<std::shared_mutex> lock(indexMutex);
+            found = bidList.Find(auctionId);
+        }
+        if (found) {
+            return *found;
+        }
+    }
+
+    // If not found in memory, look it up in the database by primary key on a read connection
+    Bid bid;
+    {
+        ConnectionPool::Lease connection = readers.Acquire();
+        StatementCache::Handle stmt = connection.statements().Acquire(StatementCache::SelectBid);
+        stmt.BindText(1, auctionId);
+
+        if (stmt.Step() != SQLITE_ROW) {
+            throw std::runtime_error("Bid not found");
+        }
+        bid = readBidRow(stmt.get());
+    }
+    if (warming) {
+        return bid;  // Warm-up will load it anyway
+    }
+
+    // The bid was added outside this program. Read it again under the writer lock before
+    // adding it to memory, so a delete committed in between cannot be undone.
+    std::lock_guard<std::mutex> lock(storeMutex);
+    StatementCache::Handle stmt = statements.Acquire(StatementCache::SelectBid);
+    stmt.BindText(1, auctionId);
+
+    if (stmt.Step() != SQLITE_ROW) {
+        throw std::runtime_error("Bid not found");
+    }
+
+    bid = readBidRow(stmt.get());
+
+    // Add to in-memory list for future quick access
+    if (!warming) {
+        storeUpsert(bid);
+    }
+
+    return bid;
+}
+
+// Get all bids as a view over the current snapshot
+BidView DatabaseManager::getAllBids() {
+    return BidView(getSnapshot());
+}
+
+// Get the current immutable snapshot of the in-memory list, or of the database while warming up
+std::shared_ptr<const BidSnapshot> DatabaseManager::getSnapshot() {
+    if (warming) {
+        return readSnapshotFromDatabase();
+    }
+    return publishedSnapshot();
+}
+
+// Update an existing bid
+void DatabaseManager::updateBid(const Bid& bid) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    StatementCache::Handle stmt = statements.Acquire(StatementCache::UpdateBid);
+
+    // Bind values to the prepared statement
+    stmt.BindText(1, bid.auctionTitle);
+    stmt.BindText(2, bid.department);
+    stmt.BindText(3, bid.closeDate);
+    stmt.BindDouble(4, bid.winningBid);
+    stmt.BindDouble(5, bid.ccFee);
+    stmt.BindDouble(6, bid.feePercent);
+    stmt.BindDouble(7, bid.auctionFeeSubtotal);
+    stmt.BindDouble(8, bid.auctionFeeTotal);
+    stmt.BindText(9, bid.payStatus);
+    stmt.BindText(10, bid.paidDate);
+    stmt.BindText(11, bid.assetNumber);
+    stmt.BindText(12, bid.inventoryId);
+    stmt.BindText(13, bid.decalVehicleId);
+    stmt.BindText(14, bid.vtrNumber);
+    stmt.BindText(15, bid.receiptNumber);
+    stmt.BindDouble(16, bid.cap);
+    stmt.BindDouble(17, bid.expenses);
+    stmt.BindDouble(18, bid.netSales);
+    stmt.BindText(19, bid.fund);
+    stmt.BindText(20, bid.businessUnit);
+    stmt.BindText(21, bid.auctionId);
+
+    if (stmt.Step() != SQLITE_DONE) {
+        throw std::runtime_error("Failed to update bid: " + std::string(sqlite3_errmsg(db)));
+    }
+    if (sqlite3_changes(db) == 0) {
+        throw std::runtime_error("Bid not found");
+    }
+    memoryGeneration += static_cast<uint64_t>(sqlite3_changes(db));
+
+    // Update in-memory list
+    storeUpsert(bid);
+}
+
+// Delete a bid by its auction ID
+void DatabaseManager::deleteBid(const std::string& auctionId) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    StatementCache::Handle stmt = statements.Acquire(StatementCache::DeleteBid);
+    stmt.BindText(1, auctionId);
+
+    if (stmt.Step() != SQLITE_DONE) {
+        throw std::runtime_error("Failed to delete bid: " + std::string(sqlite3_errmsg(db)));
+    }
+    if (sqlite3_changes(db) == 0) {
+        throw std::runtime_error("Bid not found");
+    }
+    memoryGeneration += static_cast<uint64_t>(sqlite3_changes(db));
+
+    // Remove from in-memory list and column store
+    storeRemove(auctionId);
+}
+
+// Add a new user to the database
+void DatabaseManager::addUser(const User& user) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    StatementCache::Handle stmt = statements.Acquire(StatementCache::InsertUser);
+    stmt.BindText(1, user.username);
+    stmt.BindText(2, user.passwordHash);
+
+    if (stmt.Step() != SQLITE_DONE) {
+        throw std::runtime_error("Failed to insert user: " + std::string(sqlite3_errmsg(db)));
+    }
+}
+
+// Retrieve a user by username
+User DatabaseManager::getUser(const std::string& username) {
+    ConnectionPool::Lease connection = readers.Acquire();
+    StatementCache::Handle stmt = connection.statements().Acquire(StatementCache::SelectUser);
+    stmt.BindText(1, username);
+
+    if (stmt.Step() != SQLITE_ROW) {
+        throw std::runtime_error("User not found");
+    }
+
+    User user;
+    user.username = columnText(stmt.get(), 0);
+    user.passwordHash = columnText(stmt.get(), 1);
+    return user;
+}
+
+// Validate user credentials
+bool DatabaseManager::validateUser(const std::string& username, const std::string& password) {
+    try {
+        User user = getUser(username);
+        return user.passwordHash == hashPassword(password);
+    }
+    catch (const std::runtime_error&) {
+        return false;
+    }
+}
+
+// Target size of the byte ranges a CSV file is split into for parallel parsing
+static const size_t importChunkBytes = 4 * 1024 * 1024;
+
+// Parsed ranges each parsing thread may run ahead of the inserting thread
+static const size_t importChunksPerThread = 2;
+
+// A row that could not be converted to a bid; line counts from the start of its range
+struct CSVReject {
+    unsigned long line;
+    const char* reason;
+    std::string detail;
+
+    CSVReject() : line(0), reason("") {}
+};
+
+// Bids and rejects parsed from one range of a CSV file
+struct CSVChunk {
+    std::vector<Bid> bids;
+    std::vector<CSVReject> rejects;
+    size_t rows;
+    unsigned long lines;
+    std::exception_ptr error;
+    bool corrupted;
+    bool ready;
+
+    CSVChunk() : rows(0), lines(0), corrupted(false), ready(false) {}
+};
+
+// Parse and convert every row of one range. Runs on a parsing thread.
+static void parseCSVChunk(csv::RangeReader& range, const BidCSVSchema& schema, CSVChunk& chunk) {
+    try {
+        csv::RowView row(range.getHeader());
+        while (range.next(row)) {
+            chunk.rows++;
+
+            Bid bid;
+            CSVReject reject;
+            if (schema.Apply(row, bid, reject.detail)) {
+                chunk.bids.push_back(std::move(bid));
+            }
+            else {
+                reject.line = range.lineNumber();
+                reject.reason = "Error converting values in row";
+                chunk.rejects.push_back(std::move(reject));
+            }
+        }
+    }
+    catch (const csv::Error&) {
+        chunk.corrupted = true;
+    }
+    catch (...) {
+        chunk.error = std::current_exception();
+    }
+    chunk.lines = range.lineNumber();
+}
+
+// Run one of the cached transaction control statements on the writer connection
+void DatabaseManager::executeStatement(StatementCache::StatementId id) {
+    runStatement(db, statements, id);
+}
+
+// Insert a batch of bids in one transaction, then add the accepted ones to memory in bulk.
+// Rows that violate a constraint (e.g. a duplicate auction ID) are rejected individually;
+// any other failure rolls back the whole batch.
+void DatabaseManager::insertBatch(std::vector<Bid>& batch, ImportSummary& summary) {
+    if (batch.empty()) {
+        return;
+    }
+
+    std::vector<Bid> accepted;
+    accepted.reserve(batch.size());
+
+    std::lock_guard<std::mutex> lock(storeMutex);
+    executeStatement(StatementCache::BeginTransaction);
+    try {
+        for (Bid& bid : batch) {
+            int rc = insertBidRow(bid);
+            if (rc == SQLITE_DONE) {
+                accepted.push_back(std::move(bid));
+            }
+            else if ((rc & 0xFF) == SQLITE_CONSTRAINT) {
+                std::cerr << "Rejected bid " << bid.auctionId << ": " << sqlite3_errmsg(db) << std::endl;
+                summary.rejected++;
+            }
+            else {
+                throw std::runtime_error("Failed to insert bid: " + std::string(sqlite3_errmsg(db)));
+            }
+        }
+        executeStatement(StatementCache::CommitTransaction);
+    }
+    catch (...) {
+        try {
+            executeStatement(StatementCache::RollbackTransaction);
+        }
+        catch (const std::exception&) {
+            // The original error is the one worth reporting
+        }
+        throw;
+    }
+
+    summary.imported += accepted.size();
+    memoryGeneration += accepted.size();
+    if (warming) {
+        for (const Bid& bid : accepted) {
+            storeUpsert(bid);
+        }
+        return;
+    }
+
+    // Update the in-memory list and indexes once per committed batch
+    std::unique_lock<std::shared_mutex> indexLock(indexMutex);
+    for (const Bid& bid : accepted) {
+        indexes.Add(bid);
+    }
+    bidList.AppendBatch(std::move(accepted));
+    retireSnapshot();
+}
+
+// Import bids from a CSV file. The memory-mapped file is split into ranges on line
+// boundaries; a pool of threads parses and converts the ranges while this thread
+// inserts them, in file order, in transactions of batchSize rows. Parsing threads
+// may only run a few ranges ahead of the inserts, so memory use does not depend
+// on file size, and the result and diagnostics are the same as a serial import.
+ImportSummary DatabaseManager::importFromCSV(const std::string& filename, size_t batchSize) {
+    std::cout << "Attempting to import CSV from: " << filename << std::endl;
+    if (batchSize == 0) {
+        batchSize = 1;
+    }
+
+    ImportSummary summary;
+    auto start = std::chrono::steady_clock::now();
+
+    std::unique_ptr<csv::MappedReader> reader;
+    try {
+        reader.reset(new csv::MappedReader(filename));
+    }
+    catch (csv::Error& e) {
+        std::cerr << "CSV Parser error: " << e.what() << std::endl;
+        throw std::runtime_error(std::string("CSV Parser error: ") + e.what());
+    }
+
+    // Bind columns to bid fields by header name, once for the whole file
+    BidCSVSchema schema(reader->getHeader());
+    if (!schema.MissingFields().empty()) {
+        std::cout << "CSV has no column for:";
+        for (const std::string& field : schema.MissingFields()) {
+            std::cout << " \"" << field << "\"";
+        }
+        std::cout << "; those fields keep their default values" << std::endl;
+    }
+    if (!schema.IgnoredColumns().empty()) {
+        std::cout << "Ignoring unrecognized CSV columns:";
+        for (const std::string& column : schema.IgnoredColumns()) {
+            std::cout << " \"" << column << "\"";
+        }
+        std::cout << std::endl;
+    }
+
+    std::vector<csv::RangeReader> ranges = reader->split(importChunkBytes);
+    size_t threadCount = std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(), ranges.size()));
+    size_t window = threadCount * importChunksPerThread;
+    std::cout << "Successfully opened CSV file. Columns: " << reader->columnCount()
+        << ", ranges: " << ranges.size() << ", parsing threads: " << threadCount << std::endl;
+
+    std::vector<CSVChunk> chunks(ranges.size());
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t nextChunk = 0;
+    size_t consumed = 0;
+    bool cancelled = false;
+
+    auto parseWorker = [&]() {
+        for (;;) {
+            size_t index;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]() { return cancelled || nextChunk >= ranges.size() || nextChunk < consumed + window; });
+                if (cancelled || nextChunk >= ranges.size()) {
+                    return;
+                }
+                index = nextChunk++;
+            }
+
+            CSVChunk chunk;
+            parseCSVChunk(ranges[index], schema, chunk);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            chunks[index] = std::move(chunk);
+            chunks[index].ready = true;
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    auto stopWorkers = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            cancelled = true;
+            changed.notify_all();
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+    };
+
+    try {
+        for (size_t i = 0; i < threadCount; i++) {
+            workers.emplace_back(parseWorker);
+        }
+
+        // Lines before the first range (the header, and any blank lines before it)
+        unsigned long lineBase = reader->lineNumber();
+        std::vector<Bid> batch;
+        batch.reserve(batchSize);
+
+        for (size_t index = 0; index < chunks.size(); index++) {
+            CSVChunk chunk;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]() { return chunks[index].ready; });
+                chunk = std::move(chunks[index]);
+                chunks[index] = CSVChunk();
+                consumed = index + 1;
+                changed.notify_all();
+            }
+
+            for (const CSVReject& reject : chunk.rejects) {
+                std::cerr << reject.reason << " " << (lineBase + reject.line) << ": " << reject.detail << std::endl;
+            }
+            if (chunk.error) {
+                std::rethrow_exception(chunk.error);
+            }
+            if (chunk.corrupted) {
+                std::string message = "corrupted data at line " + std::to_string(lineBase + chunk.lines) + " !";
+                std::cerr << "CSV Parser error: " << message << std::endl;
+                throw std::runtime_error("CSV Parser error: " + message);
+            }
+
+            summary.rows += chunk.rows;
+            summary.rejected += chunk.rejects.size();
+            lineBase += chunk.lines;
+
+            for (Bid& bid : chunk.bids) {
+                batch.push_back(std::move(bid));
+                if (batch.size() >= batchSize) {
+                    insertBatch(batch, summary);
+                    batch.clear();
+                }
+            }
+        }
+        insertBatch(batch, summary);
+    }
+    catch (...) {
+        stopWorkers();
+        std::cerr << "Error during CSV import, the current batch was rolled back" << std::endl;
+        throw;
+    }
+    stopWorkers();
+
+    summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    summary.rowsPerSecond = (summary.seconds > 0) ? summary.rows / summary.seconds : 0;
+
+    std::cout << "CSV import completed: " << summary.imported << " of " << summary.rows << " rows imported, "
+        << summary.rejected << " rejected, " << summary.seconds << " s (" << summary.rowsPerSecond << " rows/s)" << std::endl;
+    return summary;
+}
+
+// Sum a numeric column for each value of a group column, e.g. net sales per department
+std::vector<std::pair<std::string, double>> DatabaseManager::getColumnTotals(BidColumnStore::GroupColumn group, BidColumnStore::NumericColumn column) {
+    if (warming) {
+        // The column store is built along with the in-memory store; until then, let the
+        // database add up the column. Groups come in value order rather than first-seen order.
+        ConnectionPool::Lease connection = readers.Acquire();
+        StatementCache::Handle stmt = connection.statements().Acquire(StatementCache::SumByGroup);
+        stmt.BindInt(1, static_cast<int>(group));
+        stmt.BindInt(2, static_cast<int>(column));
+
+        std::vector<std::pair<std::string, double>> totals;
+        int rc;
+        while ((rc = stmt.Step()) == SQLITE_ROW) {
+            totals.emplace_back(columnText(stmt.get(), 0), sqlite3_column_double(stmt.get(), 1));
+        }
+        if (rc != SQLITE_DONE) {
+            throw std::runtime_error("Failed to total bids: " + std::string(sqlite3_errmsg(connection.db())));
+        }
+        return totals;
+    }
+
+    // The column store is updated by every write, so reports stream through it directly
+    std::shared_lock<std::shared_mutex> lock(indexMutex);
+    return indexes.columns.SumBy(group, column);
+}
+
+// New methods using LinkedList functionalities
+// Perform binary search on the bid list's sorted auction ID index
+Bid DatabaseManager::binarySearchBid(const std::string& auctionId) {
+    if (warming) {
+        // The sorted index is not built yet; the primary key lookup answers the same question
+        try {
+            return getBid(auctionId);
+        }
+        catch (const std::runtime_error&) {
+            return Bid();
+        }
+    }
+    std::shared_lock<std::shared_mutex> lock(indexMutex);
+    return bidList.BinarySearch(auctionId);
+}
+
+// Cursors are the sort key of the last bid on a page, hex encoded so that they can be
+// passed back in a query string unchanged
+static std::string encodeCursor(const std::string& key) {
+    static const char digits[] = "0123456789abcdef";
+    std::string cursor;
+    cursor.reserve(key.size() * 2);
+    for (unsigned char c : key) {
+        cursor.push_back(digits[c >> 4]);
+        cursor.push_back(digits[c & 0x0F]);
+    }
+    return cursor;
+}
+
+static std::string decodeCursor(const std::string& cursor) {
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+
+    if (cursor.size() % 2 != 0) {
+        throw std::invalid_argument("Malformed cursor");
+    }
+    std::string key;
+    key.reserve(cursor.size() / 2);
+    for (size_t i = 0; i < cursor.size(); i += 2) {
+        int high = nibble(cursor[i]);
+        int low = nibble(cursor[i + 1]);
+        if (high < 0 || low < 0) {
+            throw std::invalid_argument("Malformed cursor");
+        }
+        key.push_back(static_cast<char>((high << 4) | low));
+    }
+    return key;
+}
+
+// Keyset pagination over the snapshot's cached sort orders
+BidPage DatabaseManager::getBidPage(const BidQuery& query, const std::string& cursor, size_t limit) {
+    // Cursors are "<value>\n<auction ID>" when sorting by a column and the auction ID
+    // alone otherwise, so the position is found even if that bid has since been deleted
+    BidQuery::Key after;
+    if (!cursor.empty()) {
+        std::string key = decodeCursor(cursor);
+        after.auctionId = key;
+        if (!query.SortsById()) {
+            size_t split = key.find('\n');
+            if (split == std::string::npos) {
+                throw std::invalid_argument("Malformed cursor");
+            }
+            std::string value = key.substr(0, split);
+            char* end = nullptr;
+            after.value = std::strtod(value.c_str(), &end);
+            if (value.empty() || end != value.c_str() + value.size()) {
+                throw std::invalid_argument("Malformed cursor");
+            }
+            after.auctionId = key.substr(split + 1);
+        }
+    }
+
+    // Ask for one row more than the page to learn whether another page follows.
+    // Unfiltered pages in auction ID order are read straight from the sorted index, so
+    // they cost the same after a write as before it; the rows are a snapshot of just
+    // that page.
+    std::shared_ptr<const BidSnapshot> snapshot;
+    std::vector<uint32_t> rows;
+    if (!warming && query.SortsById() && !query.HasFilters()) {
+        std::vector<BidPtr> page;
+        {
+            std::shared_lock<std::shared_mutex> lock(indexMutex);
+            page = bidList.PageById(cursor.empty() ? nullptr : &after.auctionId, limit + 1, query.SortsDescending());
+        }
+        rows.resize(page.size());
+        for (size_t row = 0; row < rows.size(); row++) {
+            rows[row] = static_cast<uint32_t>(row);
+        }
+        snapshot = std::make_shared<const BidSnapshot>(std::move(page));
+    }
+    else {
+        snapshot = getSnapshot();
+        rows = query.Execute(*snapshot, cursor.empty() ? nullptr : &after, limit + 1);
+    }
+
+    std::string next;
+    if (rows.size() > limit) {
+        rows.resize(limit);
+        BidQuery::Key last = query.KeyOf((*snapshot)[rows.back()]);
+        std::string key = last.auctionId;
+        if (!query.SortsById()) {
+            char value[32];
+            std::snprintf(value, sizeof(value), "%.17g", last.value);
+            key = std::string(value) + "\n" + last.auctionId;
+        }
+        next = encodeCursor(key);
+    }
+
+    return BidPage(BidView(std::move(snapshot), std::move(rows)), std::move(next));
+}
+
+// Whether a title's words contain every query word, the last one as a prefix; the
+// same matching a TextIndex search does
+static bool titleMatches(const std::vector<std::string>& titleWords, const std::vector<std::string>& queryWords) {
+    for (size_t w = 0; w < queryWords.size(); w++) {
+        const std::string& word = queryWords[w];
+        bool prefix = (w + 1 == queryWords.size());
+        bool matched = false;
+        for (const std::string& titleWord : titleWords) {
+            if (prefix ? titleWord.compare(0, word.size(), word) == 0 : titleWord == word) {
+                matched = true;
+                break;
+            }
+        }
+        if (!matched) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Keyword search over auction titles, most relevant first
+BidView DatabaseManager::searchBids(const std::string& query, size_t limit) {
+    if (warming) {
+        // The search indexes are built along with the in-memory store. Until then, scan
+        // the titles in the database for the longest query word and check each candidate
+        // the way the index would match it, stopping at limit matches. Results come in
+        // table order rather than by relevance.
+        std::vector<std::string> words = TextIndex::Tokenize(query);
+        std::vector<BidPtr> found;
+        if (words.empty() || limit == 0) {
+            return BidView(std::make_shared<const BidSnapshot>(std::move(found)));
+        }
+        const std::string* longest = &words[0];
+        for (const std::string& word : words) {
+            if (word.size() > longest->size()) {
+                longest = &word;
+            }
+        }
+
+        // Words are letters and digits only, so nothing in the pattern needs escaping
+        std::string pattern = "%" + *longest + "%";
+        ConnectionPool::Lease connection = readers.Acquire();
+        StatementCache::Handle stmt = connection.statements().Acquire(StatementCache::SearchTitles);
+        stmt.BindText(1, pattern);
+        int rc = SQLITE_DONE;
+        while (found.size() < limit && (rc = stmt.Step()) == SQLITE_ROW) {
+            const char* title = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0));
+            if (titleMatches(TextIndex::Tokenize(title ? title : ""), words)) {
+                found.push_back(std::make_shared<const Bid>(readBidRow(stmt.get())));
+            }
+        }
+        if (found.size() < limit && rc != SQLITE_DONE) {
+            throw std::runtime_error("Failed to search bids: " + std::string(sqlite3_errmsg(connection.db())));
+        }
+        return BidView(std::make_shared<const BidSnapshot>(std::move(found)));
+    }
+
+    // The index and the list change together, so every match is in the list; the
+    // result is a small snapshot of just the matching bids
+    std::vector<BidPtr> found;
+    {
+        std::shared_lock<std::shared_mutex> lock(indexMutex);
+        for (const TextIndex::Match& match : indexes.titles.Search(query, limit)) {
+            BidPtr bid = bidList.Find(match.auctionId);
+            if (bid) {
+                found.push_back(std::move(bid));
+            }
+        }
+    }
+    return BidView(std::make_shared<const BidSnapshot>(std::move(found)));
+}
+
+// Autocomplete over an identifier column
+std::vector<PrefixIndex::Completion> DatabaseManager::getCompletions(BidColumnStore::IdentifierColumn column, const std::string& prefix, size_t limit) {
+    if (warming) {
+        // Until warm-up ends, read the range of values starting with the prefix from the
+        // database: from the prefix up to, but not including, the first string past it
+        std::vector<PrefixIndex::Completion> completions;
+        if (limit == 0) {
+            return completions;
+        }
+        std::string upper = prefix;
+        while (!upper.empty() && static_cast<unsigned char>(upper.back()) == 0xFF) {
+            upper.pop_back();
+        }
+        if (!upper.empty()) {
+            upper.back() = static_cast<char>(static_cast<unsigned char>(upper.back()) + 1);
+        }
+
+        ConnectionPool::Lease connection = readers.Acquire();
+        StatementCache::Handle stmt = connection.statements().Acquire(StatementCache::CompleteIdentifier);
+        stmt.BindInt(1, static_cast<int>(column));
+        stmt.BindText(2, prefix);
+        if (!upper.empty()) {
+            stmt.BindText(3, upper);
+        }
+        stmt.BindInt64(4, static_cast<int64_t>(std::min<size_t>(limit, INT64_MAX)));
+
+        int rc;
+        while ((rc = stmt.Step()) == SQLITE_ROW) {
+            completions.push_back({ columnText(stmt.get(), 0), columnText(stmt.get(), 1) });
+        }
+        if (rc != SQLITE_DONE) {
+            throw std::runtime_error("Failed to read completions: " + std::string(sqlite3_errmsg(connection.db())));
+        }
+        return completions;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(indexMutex);
+    return indexes.identifiers[column].Complete(prefix, limit);
+}
+
+// Bids whose inventoryId list contains the item
+BidView DatabaseManager::getBidsByInventoryId(const std::string& item) {
+    std::vector<BidPtr> found;
+    if (warming) {
+        // Until warm-up ends, read the bids whose list mentions the item from the
+        // database and split each list to drop partial matches
+        if (item.empty()) {
+            return BidView(std::make_shared<const BidSnapshot>(std::move(found)));  // Lists never hold empty items
+        }
+        std::string pattern = "%";
+        for (char c : item) {
+            if (c == '%' || c == '_' || c == '\\') {
+                pattern.push_back('\\');
+            }
+            pattern.push_back(c);
+        }
+        pattern.push_back('%');
+
+        ConnectionPool::Lease connection = readers.Acquire();
+        StatementCache::Handle stmt = connection.statements().Acquire(StatementCache::SearchInventory);
+        stmt.BindText(1, pattern);
+        int rc;
+        while ((rc = stmt.Step()) == SQLITE_ROW) {
+            for (std::string_view listed : InventoryIndex::Items(columnText(stmt.get(), 12))) {
+                if (listed == item) {
+                    found.push_back(std::make_shared<const Bid>(readBidRow(stmt.get())));
+                    break;
+                }
+            }
+        }
+        if (rc != SQLITE_DONE) {
+            throw std::runtime_error("Failed to read bids: " + std::string(sqlite3_errmsg(connection.db())));
+        }
+        return BidView(std::make_shared<const BidSnapshot>(std::move(found)));
+    }
+
+    {
+        std::shared_lock<std::shared_mutex> lock(indexMutex);
+        const std::vector<std::string>* auctionIds = indexes.inventory.Find(item);
+        if (auctionIds != nullptr) {
+            for (const std::string& auctionId : *auctionIds) {
+                BidPtr bid = bidList.Find(auctionId);
+                if (bid) {
+                    found.push_back(std::move(bid));
+                }
+            }
+        }
+    }
+    return BidView(std::make_shared<const BidSnapshot>(std::move(found)));
+}
+
+// Enable Multi-Factor Authentication for a user
+void DatabaseManager::enableMFA(const std::string& username, const std::string& totpSecret) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    StatementCache::Handle stmt = statements.Acquire(StatementCache::EnableMFA);
+    stmt.BindText(1, totpSecret);
+    stmt.BindText(2, username);
+
+    if (stmt.Step() != SQLITE_DONE) {
+        throw std::runtime_error("Failed to enable MFA: " + std::string(sqlite3_errmsg(db)));
+    }
+}
+
+// Check if MFA is enabled for a user
+bool DatabaseManager::isMFAEnabled(const std::string& username) {
+    ConnectionPool::Lease connection = readers.Acquire();
+    StatementCache::Handle stmt = connection.statements().Acquire(StatementCache::SelectMFAEnabled);
+    stmt.BindText(1, username);
+
+    if (stmt.Step() != SQLITE_ROW) {
+        throw std::runtime_error("User not found");
+    }
+
+    return sqlite3_column_int(stmt.get(), 0) == 1;
+}
+
+// Get the TOTP secret for a user
+std::string DatabaseManager::getTOTPSecret(const std::string& username) {
+    ConnectionPool::Lease connection = readers.Acquire();
+    StatementCache::Handle stmt = connection.statements().Acquire(StatementCache::SelectTOTPSecret);
+    stmt.BindText(1, username);
+
+    if (stmt.Step() != SQLITE_ROW) {
+        throw std::runtime_error("User not found");
+    }
+
+    return columnText(stmt.get(), 0);
+}
+
+// Per-statement prepare and step timings from the statement cache
+std::vector<StatementCache::Timing> DatabaseManager::getStatementTimings() const {
+    // Writer and read connections together
+    std::vector<StatementCache::Timing> timings = statements.Timings();
+    std::vector<StatementCache::Timing> readerTimings = readers.Timings();
+    for (size_t i = 0; i < readerTimings.size(); i++) {
+        timings[i].prepareNanos += readerTimings[i].prepareNanos;
+        timings[i].executions += readerTimings[i].executions;
+        timings[i].steps += readerTimings[i].steps;
+        timings[i].stepNanos += readerTimings[i].stepNanos;
+    }
+    return timings;
 }
\ No newline at end of file
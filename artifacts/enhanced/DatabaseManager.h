@@ -1,66 +1,285 @@
-/*
- * File: DatabaseManager.h
- * Author: Thomas Gallegos
- * Email: N/A
- * Date: July 23, 2024
- * Version: 1.0
- *
- * Purpose:
- * This file defines the DatabaseManager class, which handles all database operations
- * for the Bid Management System. It provides an interface for CRUD operations on bids
- * and users, as well as additional functionality like CSV import and MFA management.
- *
- * Dependencies:
- * - sqlite3 for database operations
- * - CSVparser for CSV file parsing
- * - LinkedList for in-memory bid storage
- *
- */
-#pragma once
-#include <sqlite3.h>
-#include <string>
-#include <vector>
-#include "Bid.h"
-#include "User.h"
-#include "CSVparser.h"
-#include "LinkedList.h"
-
-class DatabaseManager {
-private:
-    sqlite3* db;  // SQLite database connection
-    LinkedList bidList;  // In-memory storage for bids
-
-    // Load bids from the database into memory
-    void loadBidsIntoMemory();
-
-public:
-    DatabaseManager();
-    ~DatabaseManager();
-
-    // Initialize the database connection and tables
-    void init();
-
-    // CRUD operations for bids
-    void addBid(const Bid& bid);
-    Bid getBid(const std::string& bidId);
-    std::vector<Bid> getAllBids();
-    void updateBid(const Bid& bid);
-    void deleteBid(const std::string& bidId);
-
-    // User management
-    void addUser(const User& user);
-    User getUser(const std::string& username);
-    bool validateUser(const std::string& username, const std::string& password);
-
-    // CSV import functionalit
-    void importFromCSV(const std::string& filename);
-
-    // Sorting and searching
-    std::vector<Bid> getSortedBids(bool (*comparator)(const Bid&, const Bid&));
-    Bid binarySearchBid(const std::string& auctionId);
-
-    // MFA management
-    void enableMFA(const std::string& username, const std::string& totpSecret);
-    bool isMFAEnabled(const std::string& username);
-    std::string getTOTPSecret(const std::string& username);
-};
+/*
+ * File: DatabaseManager.h
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file defines the DatabaseManager class, which handles all database operations
+ * for the Bid Management System. It provides an interface for CRUD operations on bids
+ * and users, as well as additional functionality like CSV import and MFA management.
+ *
+ * Dependencies:
+ * - sqlite3 for database operations
+ * - CSVparser for CSV file parsing
+ * - LinkedList for in-memory bid storage
+ * - BidSnapshot for immutable views handed out to readers
+ * - BidColumnStore for aggregate reports
+ * - BidQuery for filtered and sorted listings
+ * - TextIndex for keyword search over auction titles
+ * - PrefixIndex for autocomplete over identifiers
+ * - InventoryIndex for lookups by inventory ID
+ * - StatementCache for prepared statements
+ * - ConnectionPool for the read-only connections
+ *
+ */
+#pragma once
+#include <sqlite3.h>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include "Bid.h"
+#include "User.h"
+#include "CSVparser.h"
+#include "LinkedList.h"
+#include "BidSnapshot.h"
+#include "BidColumnStore.h"
+#include "BidQuery.h"
+#include "TextIndex.h"
+#include "PrefixIndex.h"
+#include "InventoryIndex.h"
+#include "StatementCache.h"
+#include "ConnectionPool.h"
+
+// Outcome of a CSV import
+struct ImportSummary {
+    size_t rows;       // Data rows read from the file
+    size_t imported;   // Rows inserted into the database
+    size_t rejected;   // Rows skipped because they failed to convert or insert
+    double seconds;
+    double rowsPerSecond;
+
+    ImportSummary() : rows(0), imported(0), rejected(0), seconds(0), rowsPerSecond(0) {}
+};
+
+// Progress of the background warm-up in lazy loading mode
+struct WarmupProgress {
+    bool ready;      // True once reads are served from memory
+    size_t loaded;   // Bids loaded into the staged store so far
+    size_t total;    // Bids in the table when warm-up started
+    double seconds;  // Time spent warming up, so far or in total
+
+    WarmupProgress() : ready(false), loaded(0), total(0), seconds(0) {}
+};
+
+// One page of a keyset-paginated bid listing
+struct BidPage {
+    BidView bids;
+    std::string nextCursor;  // Cursor for the following page; empty on the last page
+
+    BidPage(BidView someBids, std::string aNextCursor) : bids(std::move(someBids)), nextCursor(std::move(aNextCursor)) {}
+};
+
+class DatabaseManager {
+private:
+    std::string databasePath;
+    size_t readConnectionCount;
+    sqlite3* db;  // Writer connection; used only under storeMutex
+    StatementCache statements;  // Writer statements, compiled once at init()
+    ConnectionPool readers;  // Read-only connections for queries that go to the database
+    // In-memory storage for bids. Its hash index answers lookups by auction ID and its
+    // sorted index binary searches.
+    LinkedList bidList;
+
+    // Keyword index over auction titles, autocomplete indexes over identifiers, the
+    // inventory ID to auction index and the report columns
+    struct BidIndexes {
+        TextIndex titles;
+        std::vector<PrefixIndex> identifiers;  // One per BidColumnStore::IdentifierColumn
+        InventoryIndex inventory;
+        BidColumnStore columns;
+
+        BidIndexes();
+        void Add(const Bid& bid);
+        void Remove(const std::string& auctionId);
+
+        // Build from a snapshot; the inventory index is left alone when it was
+        // already loaded from the bid store file
+        void Build(const BidSnapshot& snapshot, bool withInventory);
+        void Swap(BidIndexes& other);
+    };
+
+    // Kept in step with bidList, and updated in place by every write
+    BidIndexes indexes;
+
+    // Guards bidList and indexes. Writers change them under storeMutex and an exclusive
+    // lock held only for the in-memory update; lookups take it shared, so they wait at
+    // most for one such update and never for SQLite.
+    std::shared_mutex indexMutex;
+
+    // Snapshot of bidList for listings. Writers clear it rather than copy the list on
+    // every change; the first listing after a change builds the next one, under
+    // snapshotMutex so that only one reader does. Accessed only through
+    // std::atomic_load/atomic_store, so once built, readers take no lock, and a reader
+    // keeps the snapshot it loaded for as long as it needs it.
+    std::shared_ptr<const BidSnapshot> published;
+    std::mutex snapshotMutex;  // Taken before indexMutex, after storeMutex
+
+    // Binary copy of the bids, loaded at startup instead of the bids table when it
+    // matches the database's change counter (generation)
+    std::string storePath;
+    std::atomic<uint64_t> savedGeneration;
+    std::mutex storeMutex;  // Serializes writers and every use of the connection and its statements
+
+    // Generation that bidList matches: set when the bids are loaded and advanced only by
+    // this process's own writes, one per row changed, as the triggers do. When the
+    // database's counter has moved past it, the database was changed outside this
+    // process and the in-memory bids may be missing that change. Guarded by storeMutex.
+    uint64_t memoryGeneration;
+    bool outsideChangeReported;
+    std::thread storeWriter;
+    std::mutex storeWriterMutex;
+    std::condition_variable storeWriterWake;
+    bool stopStoreWriter;
+
+    // Lazy loading: while warming, a background thread builds the in-memory store and
+    // reads go to the database. Changes committed meanwhile are logged and replayed
+    // onto the staged store before it replaces the live one.
+    struct PendingWrite {
+        bool remove;
+        Bid bid;  // Only the auction ID is set for a remove
+    };
+    std::atomic<bool> warming;
+    std::atomic<bool> stopWarmup;
+    std::atomic<size_t> warmupLoaded;
+    std::atomic<size_t> warmupTotal;
+    std::atomic<int64_t> warmupNanos;  // Set when warm-up ends
+    std::chrono::steady_clock::time_point warmupStart;
+    std::vector<PendingWrite> pendingWrites;  // Guarded by storeMutex
+    std::thread warmupThread;
+
+    // Last listing read from the database while warming, reused until the generation changes
+    std::mutex databaseSnapshotMutex;
+    std::shared_ptr<const BidSnapshot> databaseSnapshot;
+    uint64_t databaseSnapshotGeneration;
+
+    // Load bids from the database into memory
+    void loadBidsIntoMemory();
+
+    // Build the in-memory store in the background, then switch reads over to it
+    void warmUp();
+
+    // Apply a committed change to the in-memory store, or log it while warming.
+    // Callers hold storeMutex.
+    void storeUpsert(const Bid& bid);
+    void storeRemove(const std::string& auctionId);
+
+    // Drop the published snapshot after a change. Callers hold indexMutex exclusively.
+    void retireSnapshot();
+
+    // The published snapshot of bidList, built first if a change retired it
+    std::shared_ptr<const BidSnapshot> publishedSnapshot();
+
+    // Every bid read straight from the database on a read connection, for listings while warming
+    std::shared_ptr<const BidSnapshot> readSnapshotFromDatabase();
+
+    // Load bids from the store file; false if it is missing, stale or corrupt
+    bool loadStoreFile(uint64_t generation);
+
+    // Current value of the database's change counter
+    uint64_t readGeneration();
+
+    // Helpers for single and batched inserts
+    int insertBidRow(const Bid& bid);
+    void executeStatement(StatementCache::StatementId id);
+    void insertBatch(std::vector<Bid>& batch, ImportSummary& summary);
+
+public:
+    // The bid store file is kept next to the database, with a .store extension.
+    // readConnections is the number of read-only connections in the pool.
+    explicit DatabaseManager(const std::string& aDatabasePath = "bids.db", size_t readConnections = 4);
+    ~DatabaseManager();
+
+    // Initialize the database connection and tables. With lazyLoad, bids are loaded
+    // into memory on a background thread and init returns immediately.
+    void init(bool lazyLoad = false);
+
+    // How far the background warm-up has got
+    WarmupProgress getWarmupProgress() const;
+
+    // CRUD operations for bids
+    void addBid(const Bid& bid);
+    Bid getBid(const std::string& bidId);
+    BidView getAllBids();
+    void updateBid(const Bid& bid);
+    void deleteBid(const std::string& bidId);
+
+    // User management
+    void addUser(const User& user);
+    User getUser(const std::string& username);
+    bool validateUser(const std::string& username, const std::string& password);
+
+    // CSV import functionality; rows are committed batchSize at a time
+    ImportSummary importFromCSV(const std::string& filename, size_t batchSize = 1000);
+
+    // Immutable snapshot of the in-memory bids; stays valid across later writes
+    std::shared_ptr<const BidSnapshot> getSnapshot();
+
+    // Sorting and searching. Results are views over a snapshot, so a sorted or
+    // filtered listing costs one row permutation rather than a copy of every bid.
+    template <typename Compare>
+    BidView getSortedBids(Compare comparator);
+    template <typename Predicate>
+    BidView getFilteredBids(Predicate predicate);
+    Bid binarySearchBid(const std::string& auctionId);
+
+    // Keyset pagination over a query: up to limit matching bids in the query's sort
+    // order, starting after the bid the cursor names; an empty cursor starts at the
+    // beginning. Throws std::invalid_argument for a malformed cursor. Unfiltered pages
+    // in auction ID order are read from the list's sorted index in O(log n + limit).
+    // Other queries run over the snapshot, so the first of them after a write
+    // rebuilds it in O(n), plus O(n log n) to sort by a column other than auctionId.
+    BidPage getBidPage(const BidQuery& query, const std::string& cursor, size_t limit);
+
+    // Keyword search over auction titles: up to limit bids whose title contains every
+    // word of the query (the last word may be partly typed), most relevant first.
+    // While warming up, the titles are scanned in the database instead and matches
+    // come in table order.
+    BidView searchBids(const std::string& query, size_t limit);
+
+    // Autocomplete: up to limit values of an identifier column that start with prefix,
+    // in ascending order, each with the auction ID of the bid that has it. While
+    // warming up, the values are read from the database.
+    std::vector<PrefixIndex::Completion> getCompletions(BidColumnStore::IdentifierColumn column, const std::string& prefix, size_t limit);
+
+    // Bids whose inventoryId list contains the item; usually one
+    BidView getBidsByInventoryId(const std::string& item);
+
+    // Aggregate reports over the column store; while warming up, the database adds up
+    // the column and the groups come in value order
+    std::vector<std::pair<std::string, double>> getColumnTotals(BidColumnStore::GroupColumn group, BidColumnStore::NumericColumn column);
+
+    // MFA management
+    void enableMFA(const std::string& username, const std::string& totpSecret);
+    bool isMFAEnabled(const std::string& username);
+    std::string getTOTPSecret(const std::string& username);
+
+    // Save the in-memory bids to the store file if the database changed since the last save
+    void saveStoreFile();
+
+    // Save the store file every interval on a background thread, and once more on shutdown
+    void startStoreWriter(std::chrono::seconds interval);
+
+    // Prepare/step timing counters for the cached statements
+    std::vector<StatementCache::Timing> getStatementTimings() const;
+};
+
+template <typename Compare>
+BidView DatabaseManager::getSortedBids(Compare comparator) {
+    std::shared_ptr<const BidSnapshot> snapshot = getSnapshot();
+    std::vector<uint32_t> order = snapshot->SortedOrder(comparator);
+    return BidView(std::move(snapshot), std::move(order));
+}
+
+template <typename Predicate>
+BidView DatabaseManager::getFilteredBids(Predicate predicate) {
+    std::shared_ptr<const BidSnapshot> snapshot = getSnapshot();
+    std::vector<uint32_t> rows = snapshot->Filter(predicate);
+    return BidView(std::move(snapshot), std::move(rows));
+}
\ No newline at end of file
@@ -0,0 +1,177 @@
+/*
+ * File: HashIndex.h
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file defines the HashIndex class template, an open-addressing hash table
+ * keyed on strings. It is used to map auction IDs to their location in the
+ * in-memory bid structures so that point lookups, updates and deletes run in
+ * constant time instead of walking the whole list.
+ *
+ * The table uses linear probing over a power-of-two slot array and backward-shift
+ * deletion, so removals never leave tombstones behind and probe sequences stay short.
+ * Keys are passed as std::string_view, so text that is not held in a std::string
+ * (for example a field of a memory-mapped file) can be looked up without copying.
+ *
+ * Dependencies: None
+ *
+ */
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+template <typename Value>
+class HashIndex {
+private:
+    // A single slot in the table; an empty slot has used == false
+    struct Slot {
+        std::string key;
+        Value value;
+        uint64_t hash;
+        bool used;
+
+        Slot() : value(), hash(0), used(false) {}
+    };
+
+    std::vector<Slot> slots;
+    size_t count;
+    size_t mask;
+
+    // Maximum load factor, expressed as a fraction of 8 to avoid floating point
+    static const size_t maxLoadEighths = 7;
+    static const size_t initialCapacity = 16;
+
+    // FNV-1a hash of the key
+    static uint64_t hashKey(std::string_view key) {
+        uint64_t h = 14695981039346656037ULL;
+        for (unsigned char c : key) {
+            h ^= c;
+            h *= 1099511628211ULL;
+        }
+        // Mix the high bits down since only the low bits pick the slot
+        h ^= h >> 32;
+        return h;
+    }
+
+    // Find the slot holding key, or the empty slot where it would go
+    size_t probe(std::string_view key, uint64_t h) const {
+        size_t i = static_cast<size_t>(h) & mask;
+        while (slots[i].used) {
+            if (slots[i].hash == h && slots[i].key == key) {
+                return i;
+            }
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    // Grow the table to newCapacity slots and reinsert every entry
+    void rehash(size_t newCapacity) {
+        std::vector<Slot> old;
+        old.swap(slots);
+        slots.resize(newCapacity);
+        mask = newCapacity - 1;
+
+        for (Slot& s : old) {
+            if (!s.used) {
+                continue;
+            }
+            size_t i = static_cast<size_t>(s.hash) & mask;
+            while (slots[i].used) {
+                i = (i + 1) & mask;
+            }
+            slots[i] = std::move(s);
+        }
+    }
+
+public:
+    HashIndex() : count(0), mask(0) {
+        slots.resize(initialCapacity);
+        mask = initialCapacity - 1;
+    }
+
+    // Insert a key, or overwrite the value if the key is already present
+    void Insert(std::string_view key, const Value& value) {
+        if ((count + 1) * 8 > slots.size() * maxLoadEighths) {
+            rehash(slots.size() * 2);
+        }
+
+        uint64_t h = hashKey(key);
+        size_t i = probe(key, h);
+        if (!slots[i].used) {
+            slots[i].key.assign(key.data(), key.size());
+            slots[i].hash = h;
+            slots[i].used = true;
+            count++;
+        }
+        slots[i].value = value;
+    }
+
+    // Look up a key; returns nullptr if it is not present
+    Value* Find(std::string_view key) {
+        uint64_t h = hashKey(key);
+        size_t i = probe(key, h);
+        return slots[i].used ? &slots[i].value : nullptr;
+    }
+
+    const Value* Find(std::string_view key) const {
+        uint64_t h = hashKey(key);
+        size_t i = probe(key, h);
+        return slots[i].used ? &slots[i].value : nullptr;
+    }
+
+    // Remove a key; returns false if it was not present
+    bool Erase(std::string_view key) {
+        uint64_t h = hashKey(key);
+        size_t i = probe(key, h);
+        if (!slots[i].used) {
+            return false;
+        }
+
+        // Backward-shift deletion: pull later entries of the cluster into the hole
+        // whenever the hole lies between their home slot and their current slot
+        size_t hole = i;
+        size_t j = (i + 1) & mask;
+        while (slots[j].used) {
+            size_t home = static_cast<size_t>(slots[j].hash) & mask;
+            if (((j - home) & mask) >= ((j - hole) & mask)) {
+                slots[hole] = std::move(slots[j]);
+                hole = j;
+            }
+            j = (j + 1) & mask;
+        }
+        slots[hole] = Slot();
+        count--;
+        return true;
+    }
+
+    // Pre-size the table so that n entries fit without rehashing
+    void Reserve(size_t n) {
+        size_t capacity = slots.size();
+        while (n * 8 > capacity * maxLoadEighths) {
+            capacity *= 2;
+        }
+        if (capacity != slots.size()) {
+            rehash(capacity);
+        }
+    }
+
+    // Remove every entry
+    void Clear() {
+        slots.assign(initialCapacity, Slot());
+        mask = initialCapacity - 1;
+        count = 0;
+    }
+
+    size_t Size() const {
+        return count;
+    }
+};
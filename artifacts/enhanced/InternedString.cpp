@@ -0,0 +1,140 @@
+/*
+ * File: InternedString.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file implements the process-wide string pool behind InternedString.
+ *
+ * Strings are stored in fixed-size chunks that are never moved or freed, so a
+ * reader can turn a code back into text with one atomic load and no lock. Only
+ * interning a string takes the pool's lock, and a shared lock is enough when the
+ * string is already present, which is the common case.
+ *
+ * Dependencies:
+ * - InternedString.h
+ * - HashIndex.h for the string-to-code lookup
+ *
+ */
+
+#include "InternedString.h"
+#include "HashIndex.h"
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+
+namespace {
+    class StringPool {
+    private:
+        static const uint32_t chunkBits = 10;
+        static const uint32_t chunkSize = 1u << chunkBits;
+        static const uint32_t maxChunks = 4096;
+
+        static const uint32_t capacity = maxChunks * chunkSize;
+
+        std::atomic<std::string*> chunks[maxChunks];
+        std::shared_mutex mutex;
+        HashIndex<uint32_t> codes;
+        uint32_t count;
+
+    public:
+        StringPool() : count(0) {
+            for (std::atomic<std::string*>& chunk : chunks) {
+                chunk.store(nullptr, std::memory_order_relaxed);
+            }
+            Intern(std::string_view(), capacity);  // The empty string is always code 0
+        }
+
+        // Code of value, adding it if there are fewer than limit strings; NotFound otherwise
+        uint32_t Intern(std::string_view value, uint32_t limit) {
+            {
+                std::shared_lock<std::shared_mutex> lock(mutex);
+                const uint32_t* found = codes.Find(value);
+                if (found != nullptr) {
+                    return *found;
+                }
+            }
+
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            const uint32_t* found = codes.Find(value);
+            if (found != nullptr) {
+                return *found;  // Another thread interned it in the meantime
+            }
+
+            uint32_t code = count;
+            if (code >= limit) {
+                return InternedString::NotFound;
+            }
+            uint32_t chunkIndex = code >> chunkBits;
+
+            std::string* chunk = chunks[chunkIndex].load(std::memory_order_relaxed);
+            if (chunk == nullptr) {
+                chunk = new std::string[chunkSize];
+                chunks[chunkIndex].store(chunk, std::memory_order_release);
+            }
+            chunk[code & (chunkSize - 1)].assign(value.data(), value.size());
+            codes.Insert(value, code);
+            count++;
+            return code;
+        }
+
+        uint32_t Intern(std::string_view value) {
+            uint32_t code = Intern(value, capacity);
+            if (code == InternedString::NotFound) {
+                throw std::runtime_error("String pool is full");
+            }
+            return code;
+        }
+
+        uint32_t Find(std::string_view value) {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            const uint32_t* found = codes.Find(value);
+            return (found != nullptr) ? *found : InternedString::NotFound;
+        }
+
+        const std::string& Lookup(uint32_t code) const {
+            return chunks[code >> chunkBits].load(std::memory_order_acquire)[code & (chunkSize - 1)];
+        }
+
+        size_t Size() {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            return count;
+        }
+    };
+
+    // The pool is created on first use and lives for the rest of the process
+    StringPool& pool() {
+        static StringPool* instance = new StringPool();
+        return *instance;
+    }
+}
+
+InternedString::InternedString(const std::string& value) : code(pool().Intern(value)) {}
+
+InternedString::InternedString(const char* value) : code(pool().Intern(value)) {}
+
+InternedString::InternedString(std::string_view value) : code(pool().Intern(value)) {}
+
+bool InternedString::TryIntern(std::string_view value, InternedString& result) {
+    uint32_t code = pool().Intern(value, MaxValues);
+    if (code == NotFound) {
+        return false;
+    }
+    result.code = code;
+    return true;
+}
+
+uint32_t InternedString::Find(std::string_view value) {
+    return pool().Find(value);
+}
+
+const std::string& InternedString::Lookup(uint32_t code) {
+    return pool().Lookup(code);
+}
+
+size_t InternedString::PoolSize() {
+    return pool().Size();
+}
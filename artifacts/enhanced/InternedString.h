@@ -0,0 +1,73 @@
+/*
+ * File: InternedString.h
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file defines the InternedString class, a 32-bit handle to a string held in
+ * a process-wide string pool. It is used for Bid fields that take only a few dozen
+ * distinct values (department, fund, pay status, business unit), so each bid stores
+ * a 4-byte code instead of its own std::string, and equality checks and group-bys
+ * compare integers.
+ *
+ * Interning takes a lock; looking up the text of a code does not. Pooled strings
+ * live for the rest of the process, so references and c_str() pointers obtained
+ * from an InternedString never dangle. Because nothing is ever freed, values that
+ * come from requests and imports go through TryIntern, which stops adding new
+ * strings at MaxValues; a client can then only get its request rejected, not fill
+ * the pool for everyone.
+ *
+ * Dependencies: None
+ *
+ */
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+class InternedString {
+private:
+    uint32_t code;
+
+public:
+    // Code returned by Find for strings that have never been interned
+    static const uint32_t NotFound = 0xFFFFFFFFu;
+
+    // The empty string, which always has code 0
+    InternedString() : code(0) {}
+
+    // Most strings TryIntern lets into the pool. The interned columns hold a few dozen
+    // distinct values, so this is far beyond any real data.
+    static const uint32_t MaxValues = 65536;
+
+    // Intern a string (implicit so that fields can be assigned from strings). For
+    // values already stored by this program, e.g. when loading the database.
+    InternedString(const std::string& value);
+    InternedString(const char* value);
+    InternedString(std::string_view value);
+
+    // Intern a string taken from a request or an import. Returns false, leaving result
+    // unchanged, when the string is new and the pool already holds MaxValues strings.
+    static bool TryIntern(std::string_view value, InternedString& result);
+
+    // Code of an already interned string, or NotFound; never adds to the pool
+    static uint32_t Find(std::string_view value);
+
+    // Text for a code previously returned by Code() or Find()
+    static const std::string& Lookup(uint32_t code);
+
+    // Number of distinct strings in the pool
+    static size_t PoolSize();
+
+    uint32_t Code() const { return code; }
+    const std::string& str() const { return Lookup(code); }
+    const char* c_str() const { return str().c_str(); }
+    bool empty() const { return code == 0; }
+    operator const std::string&() const { return str(); }
+
+    bool operator==(const InternedString& other) const { return code == other.code; }
+    bool operator!=(const InternedString& other) const { return code != other.code; }
+};
@@ -0,0 +1,133 @@
+/*
+ * File: InventoryIndex.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file implements the InventoryIndex class, the inventory ID to auction index.
+ *
+ * Dependencies:
+ * - InventoryIndex.h
+ *
+ */
+
+#include "InventoryIndex.h"
+#include <algorithm>
+#include <utility>
+
+// Index a bid's inventory items, replacing what was indexed for its auction ID before
+void InventoryIndex::Add(const Bid& bid) {
+    std::vector<std::string_view> items = Items(bid.inventoryId);
+    const std::vector<std::string>* existing = itemsOf.Find(bid.auctionId);
+    if (existing != nullptr) {
+        if (std::equal(items.begin(), items.end(), existing->begin(), existing->end())) {
+            return;
+        }
+        Remove(bid.auctionId);
+    }
+    for (std::string_view item : items) {
+        Insert(item, bid.auctionId);
+    }
+}
+
+// Record one item of a bid
+void InventoryIndex::Insert(std::string_view item, std::string_view auctionId) {
+    std::vector<std::string>* auctions = auctionsOf.Find(item);
+    if (auctions == nullptr) {
+        auctionsOf.Insert(item, std::vector<std::string>(1, std::string(auctionId)));
+    }
+    else {
+        auctions->emplace_back(auctionId);
+    }
+
+    std::vector<std::string>* items = itemsOf.Find(auctionId);
+    if (items == nullptr) {
+        itemsOf.Insert(auctionId, std::vector<std::string>(1, std::string(item)));
+    }
+    else {
+        items->emplace_back(item);
+    }
+}
+
+// Forget a bid
+void InventoryIndex::Remove(const std::string& auctionId) {
+    const std::vector<std::string>* items = itemsOf.Find(auctionId);
+    if (items == nullptr) {
+        return;
+    }
+
+    for (const std::string& item : *items) {
+        std::vector<std::string>* auctions = auctionsOf.Find(item);
+        if (auctions == nullptr) {
+            continue;
+        }
+        auctions->erase(std::remove(auctions->begin(), auctions->end(), auctionId), auctions->end());
+        if (auctions->empty()) {
+            auctionsOf.Erase(item);
+        }
+    }
+    itemsOf.Erase(auctionId);
+}
+
+// Replace the contents with every bid of a snapshot
+void InventoryIndex::Build(const BidSnapshot& snapshot) {
+    InventoryIndex built;
+    built.itemsOf.Reserve(snapshot.size());
+    built.auctionsOf.Reserve(snapshot.size());
+    for (size_t row = 0; row < snapshot.size(); row++) {
+        const Bid& bid = snapshot[row];
+        for (std::string_view item : Items(bid.inventoryId)) {
+            built.Insert(item, bid.auctionId);
+        }
+    }
+    Swap(built);
+}
+
+// Exchange contents with another index
+void InventoryIndex::Swap(InventoryIndex& other) {
+    std::swap(auctionsOf, other.auctionsOf);
+    std::swap(itemsOf, other.itemsOf);
+}
+
+// Auction IDs of the bids that list item
+const std::vector<std::string>* InventoryIndex::Find(std::string_view item) const {
+    return auctionsOf.Find(item);
+}
+
+// Number of distinct items
+size_t InventoryIndex::Size() const {
+    return auctionsOf.Size();
+}
+
+// The items of an inventoryId field
+std::vector<std::string_view> InventoryIndex::Items(std::string_view inventoryId) {
+    auto isPadding = [](char c) {
+        return c == ' ' || c == '\t' || c == '"' || c == '\r' || c == '\n';
+    };
+
+    std::vector<std::string_view> items;
+    size_t start = 0;
+    while (start <= inventoryId.size()) {
+        size_t end = inventoryId.find(',', start);
+        if (end == std::string_view::npos) {
+            end = inventoryId.size();
+        }
+
+        size_t first = start;
+        size_t last = end;
+        while (first < last && isPadding(inventoryId[first])) {
+            first++;
+        }
+        while (last > first && isPadding(inventoryId[last - 1])) {
+            last--;
+        }
+        std::string_view item = inventoryId.substr(first, last - first);
+        if (!item.empty() && std::find(items.begin(), items.end(), item) == items.end()) {
+            items.push_back(item);
+        }
+        start = end + 1;
+    }
+    return items;
+}
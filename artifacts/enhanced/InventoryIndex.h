@@ -0,0 +1,62 @@
+/*
+ * File: InventoryIndex.h
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file defines the InventoryIndex class, an inverted index from individual
+ * inventory IDs to the bids that sold them. A bid's inventoryId field often holds a
+ * comma-separated list such as "75160, 75144, 75143"; each item of the list is a key
+ * of the index, so finding the auction of an item is one hash lookup instead of a
+ * scan of every bid.
+ *
+ * The class is not thread-safe; the owner serializes changes against lookups.
+ *
+ * Dependencies:
+ * - HashIndex.h for the item and auction ID maps
+ * - BidSnapshot.h for bulk builds
+ *
+ */
+
+#pragma once
+#include "HashIndex.h"
+#include "BidSnapshot.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+class InventoryIndex {
+public:
+    // Index a bid's inventory items, replacing what was indexed for its auction ID before
+    void Add(const Bid& bid);
+
+    // Record one item of a bid, as saved by Items; used when loading a saved index
+    void Insert(std::string_view item, std::string_view auctionId);
+
+    // Forget a bid; does nothing if it is not indexed
+    void Remove(const std::string& auctionId);
+
+    // Replace the contents with every bid of a snapshot
+    void Build(const BidSnapshot& snapshot);
+
+    // Exchange contents with another index in constant time
+    void Swap(InventoryIndex& other);
+
+    // Auction IDs of the bids that list item, in the order they were indexed, or
+    // nullptr if none does
+    const std::vector<std::string>* Find(std::string_view item) const;
+
+    // Number of distinct items
+    size_t Size() const;
+
+    // The items of an inventoryId field: split on commas, with surrounding spaces and
+    // quotes trimmed; empty and repeated items are left out
+    static std::vector<std::string_view> Items(std::string_view inventoryId);
+
+private:
+    HashIndex<std::vector<std::string>> auctionsOf;  // Item to auction IDs
+    HashIndex<std::vector<std::string>> itemsOf;     // Auction ID to its items
+};
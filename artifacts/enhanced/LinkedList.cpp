@@ -1,242 +1,286 @@
-/*
- * File: LinkedList.cpp
- * Author: Thomas Gallegos
- * Email: N/A
- * Date: July 23, 2024
- * Version: 1.0
- *
- * Purpose:
- * This file implements the LinkedList class, which provides an in-memory storage
- * solution for Bid objects. It includes various operations like insertion, deletion,
- * searching, and sorting.
- *
- * Dependencies:
- * - Bid.h for the Bid structure
- *
- */
-
-#include "LinkedList.h"
-#include <algorithm>
-
-LinkedList::LinkedList() : head(nullptr), tail(nullptr), size(0) {}
-
-LinkedList::~LinkedList() {
-    Node* current = head;
-    while (current != nullptr) {
-        Node* next = current->next;
-        delete current;
-        current = next;
-    }
-}
-
-// Append a new bid to the end of the list
-void LinkedList::Append(const Bid& bid) {
-    Node* newNode = new Node(bid);
-    if (head == nullptr) {
-        head = tail = newNode;
-    }
-    else {
-        tail->next = newNode;
-        newNode->prev = tail;
-        tail = newNode;
-    }
-    size++;
-}
-
-// Prepend a new bid to the beginning of the list
-void LinkedList::Prepend(const Bid& bid) {
-    Node* newNode = new Node(bid);
-    if (head == nullptr) {
-        head = tail = newNode;
-    }
-    else {
-        newNode->next = head;
-        head->prev = newNode;
-        head = newNode;
-    }
-    size++;
-}
-
-// Insert a new bid after a specified auction ID
-void LinkedList::InsertAfter(const std::string& auctionId, const Bid& newBid) {
-    Node* current = head;
-    while (current != nullptr) {
-        if (current->bid.auctionId == auctionId) {
-            Node* newNode = new Node(newBid);
-            newNode->next = current->next;
-            newNode->prev = current;
-            if (current->next) current->next->prev = newNode;
-            current->next = newNode;
-            if (current == tail) tail = newNode;
-            size++;
-            return;
-        }
-        current = current->next;
-    }
-}
-
-// Remove a bid with the specified auction ID
-void LinkedList::Remove(const std::string& auctionId) {
-    Node* current = head;
-    while (current != nullptr) {
-        if (current->bid.auctionId == auctionId) {
-            if (current->prev) current->prev->next = current->next;
-            if (current->next) current->next->prev = current->prev;
-            if (current == head) head = current->next;
-            if (current == tail) tail = current->prev;
-            delete current;
-            size--;
-            return;
-        }
-        current = current->next;
-    }
-}
-
-// Search for a bid by auction ID
-Bid LinkedList::Search(const std::string& auctionId) {
-    Node* current = head;
-    while (current != nullptr) {
-        if (current->bid.auctionId == auctionId) {
-            return current->bid;
-        }
-        current = current->next;
-    }
-    return Bid(); // Return empty bid if not found
-}
-
-// Get all bids in the list
-std::vector<Bid> LinkedList::GetAllBids() {
-    std::vector<Bid> bids;
-    Node* current = head;
-    while (current != nullptr) {
-        bids.push_back(current->bid);
-        current = current->next;
-    }
-    return bids;
-}
-// Get the size of the list
-int LinkedList::Size() const {
-    return size;
-}
-
-// Reverse the order of the list
-void LinkedList::Reverse() {
-    Node* current = head;
-    Node* temp = nullptr;
-
-    while (current != nullptr) {
-        temp = current->prev;
-        current->prev = current->next;
-        current->next = temp;
-        current = current->prev;
-    }
-
-    if (temp != nullptr) {
-        head = temp->prev;
-    }
-
-    std::swap(head, tail);
-}
-
-// Sort the list using merge sort
-void LinkedList::Sort(bool (*comparator)(const Bid&, const Bid&)) {
-    if (head == nullptr || head->next == nullptr) {
-        return; // List is empty or has only one element
-    }
-
-    head = mergeSort(head, comparator);
-
-    // Update tail and prev pointers after sorting
-    Node* current = head;
-    current->prev = nullptr;
-    while (current->next != nullptr) {
-        current->next->prev = current;
-        current = current->next;
-    }
-    tail = current;
-}
-
-// Helper function for merge sort
-LinkedList::Node* LinkedList::mergeSort(Node* node, bool (*comparator)(const Bid&, const Bid&)) {
-    if (node == nullptr || node->next == nullptr) {
-        return node;
-    }
-
-    Node* middle = getMiddle(node);
-    Node* nextToMiddle = middle->next;
-
-    middle->next = nullptr;
-
-    Node* left = mergeSort(node, comparator);
-    Node* right = mergeSort(nextToMiddle, comparator);
-
-    return merge(left, right, comparator);
-}
-
-// Helper function to merge two sorted lists
-LinkedList::Node* LinkedList::merge(Node* left, Node* right, bool (*comparator)(const Bid&, const Bid&)) {
-    if (left == nullptr) {
-        return right;
-    }
-    if (right == nullptr) {
-        return left;
-    }
-
-    Node* result;
-    if (comparator(left->bid, right->bid)) {
-        result = left;
-        result->next = merge(left->next, right, comparator);
-    }
-    else {
-        result = right;
-        result->next = merge(left, right->next, comparator);
-    }
-
-    return result;
-}
-
-// Helper function to get the middle node of the list
-LinkedList::Node* LinkedList::getMiddle(Node* head) {
-    if (head == nullptr) {
-        return head;
-    }
-
-    Node* slow = head;
-    Node* fast = head->next;
-
-    while (fast != nullptr) {
-        fast = fast->next;
-        if (fast != nullptr) {
-            slow = slow->next;
-            fast = fast->next;
-        }
-    }
-
-    return slow;
-}
-
-// Perform binary search on the sorted list
-Bid LinkedList::BinarySearch(const std::string& auctionId) {
-    // First, sort the list by auctionId
-    Sort([](const Bid& a, const Bid& b) { return a.auctionId < b.auctionId; });
-
-    Node* start = head;
-    Node* end = tail;
-
-    while (start && end && start != end->next) {
-        Node* mid = getMiddle(start);
-
-        if (mid->bid.auctionId == auctionId) {
-            return mid->bid;
-        }
-
-        if (mid->bid.auctionId < auctionId) {
-            start = mid->next;
-        }
-        else {
-            end = mid->prev;
-        }
-    }
-
-    return Bid(); // Return empty bid if not found
+/*
+ * File: LinkedList.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file implements the LinkedList class, which provides an in-memory storage
+ * solution for Bid objects. It includes various operations like insertion, deletion,
+ * searching, and sorting.
+ *
+ * Dependencies:
+ * - Bid.h for the Bid structure
+ * - HashIndex.h for constant-time lookups by auction ID
+ * - NodePool.h for slab allocation of list nodes
+ * - BidSnapshot.h for immutable copy-on-write views of the list
+ *
+ */
+
+#include "LinkedList.h"
+#include <algorithm>
+#include <utility>
+
+LinkedList::LinkedList() : head(nullptr), tail(nullptr), size(0) {}
+
+// Copy constructor: the copy gets its own nodes but shares the immutable bid records
+LinkedList::LinkedList(const LinkedList& other) : head(nullptr), tail(nullptr), size(0) {
+    index.Reserve(other.size);
+    for (Node* current = other.head; current != nullptr; current = current->next) {
+        linkBack(pool.Allocate(current->bid));
+    }
+}
+
+LinkedList::~LinkedList() {
+    // Run the node destructors, then let the pool drop its slabs in one go
+    Node* current = head;
+    while (current != nullptr) {
+        Node* next = current->next;
+        current->~Node();
+        current = next;
+    }
+    pool.Clear();
+}
+
+// Link a new node at the end of the list
+void LinkedList::linkBack(Node* newNode) {
+    if (head == nullptr) {
+        head = tail = newNode;
+    }
+    else {
+        tail->next = newNode;
+        newNode->prev = tail;
+        tail = newNode;
+    }
+    index.Insert(newNode->bid->auctionId, newNode);
+    snapshot.reset();
+    sortedInsert(newNode);
+    size++;
+}
+
+// Link a new node at the beginning of the list
+void LinkedList::linkFront(Node* newNode) {
+    if (head == nullptr) {
+        head = tail = newNode;
+    }
+    else {
+        newNode->next = head;
+        head->prev = newNode;
+        head = newNode;
+    }
+    index.Insert(newNode->bid->auctionId, newNode);
+    snapshot.reset();
+    sortedInsert(newNode);
+    size++;
+}
+
+// Insert a node into the sorted index after any nodes with the same key. The end is
+// tried first, so keys arriving in ascending order, as they do on import, go in in
+// amortized constant time; others take O(log n).
+void LinkedList::sortedInsert(Node* node) {
+    node->sortedPosition = sortedIndex.insert(sortedIndex.end(), node);
+}
+
+// Remove a node from the sorted index in amortized constant time
+void LinkedList::sortedErase(Node* node) {
+    sortedIndex.erase(node->sortedPosition);
+}
+
+// Append a new bid to the end of the list
+void LinkedList::Append(const Bid& bid) {
+    linkBack(pool.Allocate(std::make_shared<const Bid>(bid)));
+}
+
+void LinkedList::Append(Bid&& bid) {
+    linkBack(pool.Allocate(std::make_shared<const Bid>(std::move(bid))));
+}
+
+void LinkedList::Append(BidPtr bid) {
+    linkBack(pool.Allocate(std::move(bid)));
+}
+
+// Append many bids at once, sizing the hash index a single time up front
+void LinkedList::AppendBatch(std::vector<Bid>&& bids) {
+    index.Reserve(static_cast<size_t>(size) + bids.size());
+    for (Bid& bid : bids) {
+        linkBack(pool.Allocate(std::make_shared<const Bid>(std::move(bid))));
+    }
+    bids.clear();
+}
+
+// Prepend a new bid to the beginning of the list
+void LinkedList::Prepend(const Bid& bid) {
+    linkFront(pool.Allocate(std::make_shared<const Bid>(bid)));
+}
+
+void LinkedList::Prepend(Bid&& bid) {
+    linkFront(pool.Allocate(std::make_shared<const Bid>(std::move(bid))));
+}
+
+// Insert a new bid after a specified auction ID
+void LinkedList::InsertAfter(const std::string& auctionId, const Bid& newBid) {
+    Node** found = index.Find(auctionId);
+    if (found == nullptr) {
+        return;
+    }
+
+    Node* current = *found;
+    Node* newNode = pool.Allocate(std::make_shared<const Bid>(newBid));
+    newNode->next = current->next;
+    newNode->prev = current;
+    if (current->next) current->next->prev = newNode;
+    current->next = newNode;
+    if (current == tail) tail = newNode;
+    index.Insert(newBid.auctionId, newNode);
+    snapshot.reset();
+    sortedInsert(newNode);
+    size++;
+}
+
+// Remove a bid with the specified auction ID
+void LinkedList::Remove(const std::string& auctionId) {
+    Node** found = index.Find(auctionId);
+    if (found == nullptr) {
+        return;
+    }
+
+    Node* current = *found;
+    if (current->prev) current->prev->next = current->next;
+    if (current->next) current->next->prev = current->prev;
+    if (current == head) head = current->next;
+    if (current == tail) tail = current->prev;
+    index.Erase(auctionId);
+    snapshot.reset();
+    sortedErase(current);
+    pool.Release(current);
+    size--;
+}
+
+// Search for a bid by auction ID
+Bid LinkedList::Search(const std::string& auctionId) {
+    Node** found = index.Find(auctionId);
+    if (found != nullptr) {
+        return *(*found)->bid;
+    }
+    return Bid(); // Return empty bid if not found
+}
+
+// Shared record of the bid with the given auction ID, or nullptr
+BidPtr LinkedList::Find(const std::string& auctionId) const {
+    Node* const* found = index.Find(auctionId);
+    return (found != nullptr) ? (*found)->bid : BidPtr();
+}
+
+// Get all bids in the list
+std::vector<Bid> LinkedList::GetAllBids() {
+    std::vector<Bid> bids;
+    Node* current = head;
+    while (current != nullptr) {
+        bids.push_back(*current->bid);
+        current = current->next;
+    }
+    return bids;
+}
+// Get the size of the list
+int LinkedList::Size() const {
+    return size;
+}
+
+// Exchange contents with another list in constant time
+void LinkedList::Swap(LinkedList& other) {
+    pool.Swap(other.pool);
+    std::swap(head, other.head);
+    std::swap(tail, other.tail);
+    std::swap(size, other.size);
+    std::swap(index, other.index);
+    sortedIndex.swap(other.sortedIndex);
+    snapshot.swap(other.snapshot);
+}
+
+// Reverse the order of the list
+void LinkedList::Reverse() {
+    Node* current = head;
+    Node* temp = nullptr;
+
+    while (current != nullptr) {
+        temp = current->prev;
+        current->prev = current->next;
+        current->next = temp;
+        current = current->prev;
+    }
+
+    if (temp != nullptr) {
+        head = temp->prev;
+    }
+
+    std::swap(head, tail);
+    snapshot.reset();
+}
+
+// Get the shared snapshot of the list, building it if the list changed since the last one
+std::shared_ptr<const BidSnapshot> LinkedList::Snapshot() const {
+    if (!snapshot) {
+        std::vector<BidPtr> rows;
+        rows.reserve(size);
+        for (Node* current = head; current != nullptr; current = current->next) {
+            current->row = static_cast<uint32_t>(rows.size());
+            rows.push_back(current->bid);
+        }
+
+        std::vector<uint32_t> orderById;
+        orderById.reserve(sortedIndex.size());
+        for (const Node* node : sortedIndex) {
+            orderById.push_back(node->row);
+        }
+        snapshot = std::make_shared<const BidSnapshot>(std::move(rows), std::move(orderById));
+    }
+    return snapshot;
+}
+
+// Restore prev pointers and the tail after the next chain has been rebuilt by a sort.
+// The list order changed, so the cached snapshot is dropped; the sorted index and
+// the hash index point at nodes and need no change.
+void LinkedList::relink() {
+    snapshot.reset();
+    if (head == nullptr) {
+        tail = nullptr;
+        return;
+    }
+
+    Node* current = head;
+    current->prev = nullptr;
+    while (current->next != nullptr) {
+        current->next->prev = current;
+        current = current->next;
+    }
+    tail = current;
+}
+
+// Up to limit bids in auction ID order, starting after the given ID
+std::vector<BidPtr> LinkedList::PageById(const std::string* after, size_t limit, bool descending) const {
+    std::vector<BidPtr> page;
+    if (!descending) {
+        SortedIndex::const_iterator position = (after != nullptr) ? sortedIndex.upper_bound(std::string_view(*after)) : sortedIndex.begin();
+        for (; position != sortedIndex.end() && page.size() < limit; ++position) {
+            page.push_back((*position)->bid);
+        }
+    }
+    else {
+        SortedIndex::const_iterator position = (after != nullptr) ? sortedIndex.lower_bound(std::string_view(*after)) : sortedIndex.end();
+        while (position != sortedIndex.begin() && page.size() < limit) {
+            --position;
+            page.push_back((*position)->bid);
+        }
+    }
+    return page;
+}
+
+// Binary search down the sorted index; the list order is left untouched
+Bid LinkedList::BinarySearch(const std::string& auctionId) const {
+    SortedIndex::const_iterator found = sortedIndex.find(std::string_view(auctionId));
+    if (found != sortedIndex.end()) {
+        return *(*found)->bid;
+    }
+    return Bid(); // Return empty bid if not found
 }
\ No newline at end of file
@@ -1,57 +1,289 @@
-/*
- * File: LinkedList.h
- * Author: Thomas Gallegos
- * Email: N/A
- * Date: July 23, 2024
- * Version: 1.0
- *
- * Purpose:
- * This file defines the LinkedList class, which provides an in-memory storage
- * solution for Bid objects. It includes declarations for various operations
- * like insertion, deletion, searching, and sorting.
- *
- * Dependencies:
- * - Bid.h for the Bid structure
- *
- */
-
-#pragma once
-#include "Bid.h"
-#include <vector>
-
-class LinkedList {
-private:
-    // Node structure for the linked list
-    struct Node {
-        Bid bid;
-        Node* next;
-        Node* prev;
-
-        Node(Bid aBid) : bid(aBid), next(nullptr), prev(nullptr) {}
-    };
-
-    Node* head;
-    Node* tail;
-    int size;
-
-    // Helper methods for Sort
-    Node* mergeSort(Node* node, bool (*comparator)(const Bid&, const Bid&));
-    Node* merge(Node* left, Node* right, bool (*comparator)(const Bid&, const Bid&));
-    Node* getMiddle(Node* head);
-
-public:
-    LinkedList();
-    ~LinkedList();
-    void Append(const Bid& bid);
-    void Prepend(const Bid& bid);
-    void InsertAfter(const std::string& auctionId, const Bid& newBid);
-    void Remove(const std::string& auctionId);
-    Bid Search(const std::string& auctionId);
-    std::vector<Bid> GetAllBids();
-    int Size() const;
-    void Reverse();
-
-    // Sorting and searching methods
-    void Sort(bool (*comparator)(const Bid&, const Bid&));
-    Bid BinarySearch(const std::string& auctionId);
-};
+/*
+ * File: LinkedList.h
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file defines the LinkedList class, which provides an in-memory storage
+ * solution for Bid objects. It includes declarations for various operations
+ * like insertion, deletion, searching, and sorting. Listings are sorted as row
+ * orders over a BidSnapshot; Sort and ParallelSort reorder the list itself.
+ *
+ * Dependencies:
+ * - Bid.h for the Bid structure
+ * - HashIndex.h for constant-time lookups by auction ID
+ * - NodePool.h for slab allocation of list nodes
+ * - BidSnapshot.h for immutable copy-on-write views of the list
+ *
+ */
+
+#pragma once
+#include "Bid.h"
+#include "HashIndex.h"
+#include "NodePool.h"
+#include "BidSnapshot.h"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <set>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+
+class LinkedList {
+private:
+    struct Node;
+
+    // Orders nodes by auction ID. Transparent, so the sorted index can be searched
+    // by a key alone.
+    struct NodeOrder {
+        typedef void is_transparent;
+        bool operator()(const Node* a, const Node* b) const;
+        bool operator()(const Node* a, std::string_view key) const;
+        bool operator()(std::string_view key, const Node* b) const;
+    };
+
+    // Balanced tree of nodes ordered by auction ID; equal keys keep insertion order
+    typedef std::multiset<Node*, NodeOrder> SortedIndex;
+
+    // Node structure for the linked list. The bid record is shared with any
+    // snapshots that include it.
+    struct Node {
+        BidPtr bid;
+        Node* next;
+        Node* prev;
+        SortedIndex::iterator sortedPosition;  // This node's entry in sortedIndex
+        uint32_t row;  // Position in the last snapshot taken; set by Snapshot
+
+        Node(BidPtr aBid) : bid(std::move(aBid)), next(nullptr), prev(nullptr), row(0) {}
+    };
+
+    // Slab allocator that owns the storage for every node in the list
+    NodePool<Node> pool;
+
+    Node* head;
+    Node* tail;
+    int size;
+
+    // Hash index from auction ID to node, kept in sync by every insert and remove
+    HashIndex<Node*> index;
+
+    // Nodes ordered by auction ID, kept in sync by every insert and remove.
+    // BinarySearch works on this instead of reordering the list itself, and
+    // snapshots take their order by auction ID from it. Lookups and out-of-order
+    // inserts are O(log n); appending ascending IDs, as imports do, and removing a
+    // node through its sortedPosition are amortized O(1).
+    SortedIndex sortedIndex;
+
+    // Maintain the sorted index
+    void sortedInsert(Node* node);
+    void sortedErase(Node* node);
+
+    // Snapshot of the current contents, shared by readers until the next change
+    mutable std::shared_ptr<const BidSnapshot> snapshot;
+
+    // Link a freshly allocated node at the end or the beginning of the list
+    void linkBack(Node* newNode);
+    void linkFront(Node* newNode);
+
+    // Helper methods for Sort. Comparators are template parameters so that
+    // lambdas and functors are inlined into the merge loop.
+    template <typename Compare>
+    static Node* mergeRuns(Node* left, Node* right, Compare& comparator);
+    template <typename Compare>
+    static Node* sortRun(Node* first, Compare& comparator);
+    void relink();
+
+public:
+    LinkedList();
+    LinkedList(const LinkedList& other);
+    LinkedList& operator=(const LinkedList&) = delete;
+    ~LinkedList();
+    void Append(const Bid& bid);
+    void Append(Bid&& bid);
+    void Append(BidPtr bid);
+    void AppendBatch(std::vector<Bid>&& bids);
+    void Prepend(const Bid& bid);
+    void Prepend(Bid&& bid);
+    void InsertAfter(const std::string& auctionId, const Bid& newBid);
+    void Remove(const std::string& auctionId);
+    Bid Search(const std::string& auctionId);
+
+    // Shared record of the bid with the given auction ID, or nullptr
+    BidPtr Find(const std::string& auctionId) const;
+    std::vector<Bid> GetAllBids();
+    int Size() const;
+    void Reverse();
+
+    // Exchange contents with another list in constant time
+    void Swap(LinkedList& other);
+
+    // Immutable view of the current contents in list order. Repeated calls
+    // share one snapshot until the list is next modified. The snapshot's order by
+    // auction ID is taken from the sorted index rather than sorted again.
+    std::shared_ptr<const BidSnapshot> Snapshot() const;
+
+    // Up to limit bids in auction ID order, descending if asked, starting after the
+    // given ID, or at the first bid when after is null; O(log n + limit)
+    std::vector<BidPtr> PageById(const std::string* after, size_t limit, bool descending) const;
+
+    // Stable, iterative merge sort of the list itself; the sorted index is unaffected
+    template <typename Compare>
+    void Sort(Compare comparator);
+
+    // Sort on several threads (one per core by default); falls back to Sort for small
+    // lists. The comparator must be safe to call concurrently.
+    template <typename Compare>
+    void ParallelSort(Compare comparator, unsigned int threadCount = 0);
+
+    // Binary search over the sorted index, O(log n); returns an empty bid if not found
+    Bid BinarySearch(const std::string& auctionId) const;
+};
+
+inline bool LinkedList::NodeOrder::operator()(const Node* a, const Node* b) const {
+    return a->bid->auctionId < b->bid->auctionId;
+}
+
+inline bool LinkedList::NodeOrder::operator()(const Node* a, std::string_view key) const {
+    return a->bid->auctionId < key;
+}
+
+inline bool LinkedList::NodeOrder::operator()(std::string_view key, const Node* b) const {
+    return key < b->bid->auctionId;
+}
+
+// Merge two sorted runs into one. Ties are taken from the left run first,
+// which keeps the sort stable.
+template <typename Compare>
+LinkedList::Node* LinkedList::mergeRuns(Node* left, Node* right, Compare& comparator) {
+    Node* result = nullptr;
+    Node** link = &result;
+
+    while (left != nullptr && right != nullptr) {
+        if (comparator(*right->bid, *left->bid)) {
+            *link = right;
+            right = right->next;
+        }
+        else {
+            *link = left;
+            left = left->next;
+        }
+        link = &(*link)->next;
+    }
+    *link = (left != nullptr) ? left : right;
+
+    return result;
+}
+
+// Bottom-up merge sort of a null-terminated run of nodes. Runs of length 2^i
+// are kept in bins[i] and carried upward like a binary counter, so the sort
+// needs no recursion and only a fixed amount of extra space.
+template <typename Compare>
+LinkedList::Node* LinkedList::sortRun(Node* first, Compare& comparator) {
+    const int binCount = 64;
+    Node* bins[binCount] = {};
+
+    while (first != nullptr) {
+        Node* run = first;
+        first = first->next;
+        run->next = nullptr;
+
+        int i = 0;
+        for (; i < binCount - 1 && bins[i] != nullptr; i++) {
+            run = mergeRuns(bins[i], run, comparator);
+            bins[i] = nullptr;
+        }
+        bins[i] = (bins[i] != nullptr) ? mergeRuns(bins[i], run, comparator) : run;
+    }
+
+    // Lower bins hold later nodes, so merge them in as the right-hand side
+    Node* result = nullptr;
+    for (int i = 0; i < binCount; i++) {
+        if (bins[i] != nullptr) {
+            result = mergeRuns(bins[i], result, comparator);
+        }
+    }
+
+    return result;
+}
+
+// Sort the list using an iterative merge sort
+template <typename Compare>
+void LinkedList::Sort(Compare comparator) {
+    if (head == nullptr || head->next == nullptr) {
+        return; // List is empty or has only one element
+    }
+
+    head = sortRun(head, comparator);
+    relink();
+}
+
+// Sort the list by splitting it into one run per thread, sorting the runs
+// concurrently and merging them pairwise
+template <typename Compare>
+void LinkedList::ParallelSort(Compare comparator, unsigned int threadCount) {
+    // Below this size thread startup costs more than it saves
+    const int minParallelSize = 16384;
+
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (threadCount < 2 || size < minParallelSize) {
+        Sort(comparator);
+        return;
+    }
+
+    // Cut the list into threadCount runs of roughly equal length
+    std::vector<Node*> runs;
+    runs.reserve(threadCount);
+    int runLength = (size + static_cast<int>(threadCount) - 1) / static_cast<int>(threadCount);
+    Node* current = head;
+    while (current != nullptr) {
+        runs.push_back(current);
+        for (int i = 1; i < runLength && current->next != nullptr; i++) {
+            current = current->next;
+        }
+        Node* next = current->next;
+        current->next = nullptr;
+        current = next;
+    }
+
+    // Sort every run on its own thread
+    std::vector<std::thread> workers;
+    workers.reserve(runs.size());
+    for (size_t i = 0; i < runs.size(); i++) {
+        workers.emplace_back([&runs, &comparator, i]() {
+            runs[i] = sortRun(runs[i], comparator);
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // Merge neighbouring runs pairwise, one round at a time, in parallel
+    while (runs.size() > 1) {
+        size_t pairs = runs.size() / 2;
+        std::vector<std::thread> mergers;
+        mergers.reserve(pairs);
+        for (size_t i = 0; i < pairs; i++) {
+            mergers.emplace_back([&runs, &comparator, i]() {
+                runs[2 * i] = mergeRuns(runs[2 * i], runs[2 * i + 1], comparator);
+            });
+        }
+        for (std::thread& merger : mergers) {
+            merger.join();
+        }
+
+        std::vector<Node*> merged;
+        merged.reserve(pairs + 1);
+        for (size_t i = 0; i < runs.size(); i += 2) {
+            merged.push_back(runs[i]);
+        }
+        runs.swap(merged);
+    }
+
+    head = runs.front();
+    relink();
+}
@@ -0,0 +1,113 @@
+/*
+ * File: NodePool.h
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file defines the NodePool class template, a slab allocator for fixed-size
+ * objects. Objects are carved out of large contiguous slabs instead of being
+ * allocated one at a time on the heap, and released objects are kept on a free
+ * list for reuse. Destroying the pool returns every slab in one pass.
+ *
+ * A pool is owned by a single container, so allocations never touch the global
+ * heap lock except when a new slab is needed.
+ *
+ * Dependencies: None
+ *
+ */
+
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+template <typename T, size_t SlabSize = 1024>
+class NodePool {
+private:
+    // Storage for one object; while free it holds the next free slot instead
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> slabs;
+    Slot* freeList;
+    size_t nextInSlab;  // Index of the next never-used slot in the newest slab
+    size_t live;
+
+    // Get storage for one object, from the free list or the current slab
+    Slot* acquire() {
+        if (freeList != nullptr) {
+            Slot* slot = freeList;
+            freeList = slot->next;
+            return slot;
+        }
+        if (slabs.empty() || nextInSlab == SlabSize) {
+            slabs.emplace_back(new Slot[SlabSize]);
+            nextInSlab = 0;
+        }
+        return &slabs.back()[nextInSlab++];
+    }
+
+public:
+    NodePool() : freeList(nullptr), nextInSlab(0), live(0) {}
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    // Construct a new object in the pool
+    template <typename... Args>
+    T* Allocate(Args&&... args) {
+        Slot* slot = acquire();
+        T* object;
+        try {
+            object = new (slot->storage) T(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            slot->next = freeList;
+            freeList = slot;
+            throw;
+        }
+        live++;
+        return object;
+    }
+
+    // Destroy an object and put its slot on the free list
+    void Release(T* object) {
+        object->~T();
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->next = freeList;
+        freeList = slot;
+        live--;
+    }
+
+    // Drop every slab at once; the caller must already have destroyed live objects
+    void Clear() {
+        slabs.clear();
+        freeList = nullptr;
+        nextInSlab = 0;
+        live = 0;
+    }
+
+    // Exchange storage with another pool; objects stay at their addresses
+    void Swap(NodePool& other) {
+        slabs.swap(other.slabs);
+        std::swap(freeList, other.freeList);
+        std::swap(nextInSlab, other.nextInSlab);
+        std::swap(live, other.live);
+    }
+
+    // Number of objects currently allocated
+    size_t Live() const {
+        return live;
+    }
+
+    // Number of object slots reserved across all slabs
+    size_t Capacity() const {
+        return slabs.size() * SlabSize;
+    }
+};
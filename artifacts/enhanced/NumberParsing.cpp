@@ -0,0 +1,172 @@
+/*
+ * File: NumberParsing.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file implements the allocation-free number parsers declared in
+ * NumberParsing.h on top of std::from_chars.
+ *
+ * Dependencies:
+ * - NumberParsing.h
+ *
+ */
+
+#include "NumberParsing.h"
+#include <charconv>
+#include <system_error>
+
+namespace {
+    // Longest digit string accepted once separators are removed
+    const size_t maxDigits = 64;
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    // Strip surrounding whitespace and one pair of enclosing double quotes
+    std::string_view trim(std::string_view text) {
+        while (!text.empty() && isSpace(text.front())) {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && isSpace(text.back())) {
+            text.remove_suffix(1);
+        }
+        if (text.size() >= 2 && text.front() == '"' && text.back() == '"') {
+            text = text.substr(1, text.size() - 2);
+            while (!text.empty() && isSpace(text.front())) {
+                text.remove_prefix(1);
+            }
+            while (!text.empty() && isSpace(text.back())) {
+                text.remove_suffix(1);
+            }
+        }
+        return text;
+    }
+
+    // Parse an unsigned decimal such as "1,234.56", skipping thousands separators
+    ParseStatus parseDecimal(std::string_view text, double& value) {
+        char digits[maxDigits];
+        size_t length = 0;
+        bool seenDigit = false;
+        bool seenPoint = false;
+
+        for (char c : text) {
+            if (c == ',' && !seenPoint && seenDigit) {
+                continue;
+            }
+            if (c >= '0' && c <= '9') {
+                seenDigit = true;
+            }
+            else if (c == '.' && !seenPoint) {
+                seenPoint = true;
+            }
+            else {
+                return ParseStatus::Invalid;
+            }
+
+            if (length == maxDigits) {
+                return ParseStatus::OutOfRange;
+            }
+            digits[length++] = c;
+        }
+        if (!seenDigit) {
+            return ParseStatus::Invalid;
+        }
+
+        std::from_chars_result result = std::from_chars(digits, digits + length, value, std::chars_format::fixed);
+        if (result.ec == std::errc::result_out_of_range) {
+            return ParseStatus::OutOfRange;
+        }
+        if (result.ec != std::errc() || result.ptr != digits + length) {
+            return ParseStatus::Invalid;
+        }
+        return ParseStatus::Ok;
+    }
+}
+
+// Parse a dollar amount
+ParseStatus parseMoney(std::string_view text, double& value) {
+    text = trim(text);
+    value = 0;
+    if (text.empty()) {
+        return ParseStatus::Ok;
+    }
+
+    bool negative = false;
+    if (text.size() >= 2 && text.front() == '(' && text.back() == ')') {
+        negative = true;
+        text = trim(text.substr(1, text.size() - 2));
+    }
+
+    // The sign may come before or after the dollar sign: "-$5.00" or "$-5.00"
+    bool seenSign = false;
+    bool seenDollar = false;
+    while (!text.empty()) {
+        char c = text.front();
+        if ((c == '-' || c == '+') && !seenSign) {
+            seenSign = true;
+            negative = (c == '-') ? !negative : negative;
+        }
+        else if (c == '$' && !seenDollar) {
+            seenDollar = true;
+        }
+        else if (!isSpace(c)) {
+            break;
+        }
+        text.remove_prefix(1);
+    }
+
+    double amount = 0;
+    ParseStatus status = parseDecimal(text, amount);
+    if (status == ParseStatus::Ok) {
+        value = negative ? -amount : amount;
+    }
+    return status;
+}
+
+// Parse a fee percentage as a fraction
+ParseStatus parsePercent(std::string_view text, double& value) {
+    text = trim(text);
+    value = 0;
+    if (text.empty()) {
+        return ParseStatus::Ok;
+    }
+
+    bool percent = false;
+    if (text.back() == '%') {
+        percent = true;
+        text = trim(text.substr(0, text.size() - 1));
+    }
+
+    bool negative = false;
+    if (!text.empty() && (text.front() == '-' || text.front() == '+')) {
+        negative = (text.front() == '-');
+        text.remove_prefix(1);
+    }
+
+    double number = 0;
+    ParseStatus status = parseDecimal(text, number);
+    if (status == ParseStatus::Ok) {
+        number = percent ? number / 100.0 : number;
+        value = negative ? -number : number;
+    }
+    return status;
+}
+
+// Short description of a status for diagnostics
+const char* parseStatusMessage(ParseStatus status) {
+    switch (status) {
+    case ParseStatus::Ok:
+        return "ok";
+    case ParseStatus::Invalid:
+        return "not a number";
+    case ParseStatus::OutOfRange:
+        return "number out of range";
+    case ParseStatus::TooManyValues:
+        return "a new value past the limit of distinct values";
+    }
+    return "unknown";
+}
@@ -0,0 +1,40 @@
+/*
+ * File: NumberParsing.h
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file declares the number parsers used when importing bids. They accept the
+ * formats found in the monthly exports ("$1,234.56", "$-12.00", "(5.00)", "23%",
+ * "0.23", blanks and CSV-quoted values) and report failures through a status code
+ * instead of an exception, so a file with many dirty rows is not slowed down by
+ * exception handling. Parsing works directly on the field text and never allocates.
+ *
+ * Dependencies: None
+ *
+ */
+
+#pragma once
+#include <string_view>
+
+// Outcome of parsing a numeric field
+enum class ParseStatus {
+    Ok,
+    Invalid,     // Not a number in any accepted format
+    OutOfRange,  // A number, but too long or too large for a double
+    TooManyValues  // A new value for a dictionary-encoded column whose pool is full
+};
+
+// Parse a dollar amount. Accepts an optional sign before or after the dollar sign,
+// thousands separators, accounting-style parentheses for negatives and one pair of
+// enclosing double quotes. A blank field is zero.
+ParseStatus parseMoney(std::string_view text, double& value);
+
+// Parse a fee percentage as a fraction: "23%" and "0.23" both give 0.23.
+// A blank field is zero.
+ParseStatus parsePercent(std::string_view text, double& value);
+
+// Short description of a status for diagnostics
+const char* parseStatusMessage(ParseStatus status);
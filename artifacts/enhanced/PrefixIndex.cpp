@@ -0,0 +1,171 @@
+/*
+ * File: PrefixIndex.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file implements the PrefixIndex class, the sorted-array autocomplete index.
+ *
+ * Dependencies:
+ * - PrefixIndex.h
+ *
+ */
+
+#include "PrefixIndex.h"
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+// Recent inserts always allowed before a merge, however small the base
+static const size_t minRecentEntries = 256;
+
+// The recent inserts are merged once they reach this fraction of the base
+static const size_t recentFraction = 8;
+
+PrefixIndex::PrefixIndex(Field aField) : field(aField), removedInBase(0) {}
+
+// Order of entries: by value, then auction ID
+bool PrefixIndex::EntryOrder::operator()(const Entry& a, const Entry& b) const {
+    int order = a.value.compare(b.value);
+    if (order != 0) {
+        return order < 0;
+    }
+    return a.auctionId < b.auctionId;
+}
+
+// Index a bid's value, replacing what was indexed for its auction ID before
+void PrefixIndex::Add(const Bid& bid) {
+    const std::string& value = field(bid);
+    const std::string* existing = valueOf.Find(bid.auctionId);
+    if (existing != nullptr) {
+        if (*existing == value) {
+            return;
+        }
+        Remove(bid.auctionId);
+    }
+    if (value.empty()) {
+        return;
+    }
+
+    recent.insert(Entry{ value, bid.auctionId, false });
+    valueOf.Insert(bid.auctionId, value);
+
+    if (recent.size() > std::max(minRecentEntries, base.size() / recentFraction)) {
+        merge();
+    }
+}
+
+// Forget a bid
+void PrefixIndex::Remove(const std::string& auctionId) {
+    const std::string* value = valueOf.Find(auctionId);
+    if (value == nullptr) {
+        return;
+    }
+
+    EntryOrder less;
+    Entry key{ *value, auctionId, false };
+    if (recent.erase(key) == 0) {
+        auto inBase = std::lower_bound(base.begin(), base.end(), key, less);
+        if (inBase != base.end() && !less(key, *inBase) && !inBase->removed) {
+            inBase->removed = true;
+            removedInBase++;
+        }
+    }
+    valueOf.Erase(auctionId);
+
+    // Removed entries are skipped by lookups, but too many of them make lookups slow
+    if (removedInBase > minRecentEntries && removedInBase * 4 > base.size()) {
+        merge();
+    }
+}
+
+// Replace the contents with every bid of a snapshot
+void PrefixIndex::Build(const BidSnapshot& snapshot) {
+    PrefixIndex built(field);
+    built.base.reserve(snapshot.size());
+    built.valueOf.Reserve(snapshot.size());
+    for (size_t row = 0; row < snapshot.size(); row++) {
+        const Bid& bid = snapshot[row];
+        const std::string& value = field(bid);
+        if (!value.empty()) {
+            built.base.push_back(Entry{ value, bid.auctionId, false });
+            built.valueOf.Insert(bid.auctionId, value);
+        }
+    }
+    std::sort(built.base.begin(), built.base.end(), EntryOrder());
+    Swap(built);
+}
+
+// Exchange contents with another index
+void PrefixIndex::Swap(PrefixIndex& other) {
+    std::swap(field, other.field);
+    base.swap(other.base);
+    recent.swap(other.recent);
+    std::swap(removedInBase, other.removedInBase);
+    std::swap(valueOf, other.valueOf);
+}
+
+// Number of indexed bids
+size_t PrefixIndex::Size() const {
+    return valueOf.Size();
+}
+
+// Up to limit values starting with prefix, in ascending order
+std::vector<PrefixIndex::Completion> PrefixIndex::Complete(std::string_view prefix, size_t limit) const {
+    std::vector<Completion> completions;
+
+    auto matches = [prefix](const Entry& entry) {
+        return entry.value.compare(0, prefix.size(), prefix.data(), prefix.size()) == 0;
+    };
+
+    // Both are sorted, so the completions are the front of their merged runs. An empty
+    // auction ID orders the key before every entry with the prefix as its value.
+    EntryOrder less;
+    Entry start{ std::string(prefix), std::string(), false };
+    auto b = std::lower_bound(base.begin(), base.end(), start, less);
+    auto r = recent.lower_bound(start);
+    while (completions.size() < limit) {
+        bool baseLeft = (b != base.end() && matches(*b));
+        bool recentLeft = (r != recent.end() && matches(*r));
+        if (!baseLeft && !recentLeft) {
+            break;
+        }
+
+        const Entry* next;
+        if (baseLeft && (!recentLeft || less(*b, *r))) {
+            next = &*b++;
+        }
+        else {
+            next = &*r++;
+        }
+        if (!next->removed) {
+            completions.push_back(Completion{ next->value, next->auctionId });
+        }
+    }
+    return completions;
+}
+
+// Merge the recent inserts into the base, dropping removed entries
+void PrefixIndex::merge() {
+    if (removedInBase > 0) {
+        base.erase(std::remove_if(base.begin(), base.end(), [](const Entry& entry) { return entry.removed; }), base.end());
+        removedInBase = 0;
+    }
+
+    // Merge from the back so the base array is reused rather than copied
+    EntryOrder less;
+    size_t b = base.size();
+    size_t out = b + recent.size();
+    base.resize(out);
+    while (!recent.empty()) {
+        auto last = std::prev(recent.end());
+        if (b > 0 && less(*last, base[b - 1])) {
+            base[--out] = std::move(base[--b]);
+        }
+        else {
+            base[--out] = std::move(recent.extract(last).value());
+        }
+    }
+}
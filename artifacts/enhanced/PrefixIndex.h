@@ -0,0 +1,89 @@
+/*
+ * File: PrefixIndex.h
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file defines the PrefixIndex class, a sorted-array index over one identifier
+ * field of the bids (auction ID, asset number, ...) for autocomplete. The completions
+ * of a prefix are a contiguous run of the array, so the first few are found with one
+ * binary search and read in order, without looking at any other entry.
+ *
+ * Entries are kept in a large sorted base array and an ordered set of recent inserts.
+ * An insert goes into the set in logarithmic time, and once the set holds an eighth
+ * as many entries as the base it is merged in, so on average each insert moves a few
+ * base entries rather than half the array. Removed base entries are flagged and
+ * dropped at the next merge. Lookups read the array and the set side by side.
+ *
+ * The class is not thread-safe; the owner serializes changes against lookups.
+ *
+ * Dependencies:
+ * - HashIndex.h for the auction ID to value map
+ * - BidSnapshot.h for bulk builds
+ *
+ */
+
+#pragma once
+#include "HashIndex.h"
+#include "BidSnapshot.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <set>
+#include <cstddef>
+
+class PrefixIndex {
+public:
+    // A value of the field that starts with the prefix, and the bid that has it
+    struct Completion {
+        std::string value;
+        std::string auctionId;
+    };
+
+    // Which bid field a PrefixIndex covers
+    typedef const std::string& (*Field)(const Bid& bid);
+
+    explicit PrefixIndex(Field aField);
+
+    // Index a bid's value, replacing what was indexed for its auction ID before.
+    // Empty values are not indexed.
+    void Add(const Bid& bid);
+
+    // Forget a bid; does nothing if it is not indexed
+    void Remove(const std::string& auctionId);
+
+    // Replace the contents with every bid of a snapshot
+    void Build(const BidSnapshot& snapshot);
+
+    // Exchange contents with another index in constant time
+    void Swap(PrefixIndex& other);
+
+    // Up to limit values starting with prefix, in ascending order (ties by auction ID)
+    std::vector<Completion> Complete(std::string_view prefix, size_t limit) const;
+
+    // Number of indexed bids
+    size_t Size() const;
+
+private:
+    struct Entry {
+        std::string value;
+        std::string auctionId;
+        bool removed;  // Only set in the base array
+    };
+
+    // Order of entries: by value, then auction ID
+    struct EntryOrder {
+        bool operator()(const Entry& a, const Entry& b) const;
+    };
+
+    Field field;
+    std::vector<Entry> base;
+    std::set<Entry, EntryOrder> recent;
+    size_t removedInBase;
+    HashIndex<std::string> valueOf;  // Auction ID to its indexed value
+
+    // Merge the recent inserts into the base, dropping removed entries
+    void merge();
+};
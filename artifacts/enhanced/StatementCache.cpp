@@ -0,0 +1,207 @@
+/*
+ * File: StatementCache.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file implements the StatementCache class, which holds the compiled form of
+ * every fixed SQL statement used by the DatabaseManager along with timing counters.
+ *
+ * Dependencies:
+ * - sqlite3 for database operations
+ *
+ */
+
+#include "StatementCache.h"
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+    uint64_t nanosSince(std::chrono::steady_clock::time_point start) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+}
+
+const char* const StatementCache::sqlText[StatementCount] = {
+    // SelectAllBids
+    "SELECT * FROM bids;",
+    // InsertBid
+    "INSERT INTO bids (auction_title, auction_id, department, close_date, winning_bid, cc_fee, fee_percent, auction_fee_subtotal, auction_fee_total, pay_status, paid_date, asset_number, inventory_id, decal_vehicle_id, vtr_number, receipt_number, cap, expenses, net_sales, fund, business_unit) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);",
+    // SelectBid
+    "SELECT * FROM bids WHERE auction_id = ?;",
+    // UpdateBid
+    "UPDATE bids SET auction_title = ?, department = ?, close_date = ?, winning_bid = ?, cc_fee = ?, fee_percent = ?, auction_fee_subtotal = ?, auction_fee_total = ?, pay_status = ?, paid_date = ?, asset_number = ?, inventory_id = ?, decal_vehicle_id = ?, vtr_number = ?, receipt_number = ?, cap = ?, expenses = ?, net_sales = ?, fund = ?, business_unit = ? WHERE auction_id = ?;",
+    // DeleteBid
+    "DELETE FROM bids WHERE auction_id = ?;",
+    // InsertUser
+    "INSERT INTO users (username, password_hash) VALUES (?, ?);",
+    // SelectUser
+    "SELECT * FROM users WHERE username = ?;",
+    // EnableMFA
+    "UPDATE users SET totp_secret = ?, mfa_enabled = 1 WHERE username = ?;",
+    // SelectMFAEnabled
+    "SELECT mfa_enabled FROM users WHERE username = ?;",
+    // SelectTOTPSecret
+    "SELECT totp_secret FROM users WHERE username = ?;",
+    // BeginTransaction
+    "BEGIN;",
+    // CommitTransaction
+    "COMMIT;",
+    // RollbackTransaction
+    "ROLLBACK;",
+    // SelectGeneration
+    "SELECT value FROM meta WHERE key = 'generation';",
+    // CountBids
+    "SELECT COUNT(*) FROM bids;",
+    // SelectBidPage
+    "SELECT *, rowid FROM bids WHERE rowid > ? ORDER BY rowid LIMIT ?;",
+    // SearchTitles
+    "SELECT * FROM bids WHERE auction_title LIKE ?;",
+    // CompleteIdentifier: ?1 picks the column in BidColumnStore::IdentifierColumn order,
+    // ?2 and ?3 bound the values starting with the prefix (no upper bound when ?3 is NULL)
+    "SELECT value, auction_id FROM (SELECT CASE ?1 WHEN 0 THEN auction_id WHEN 1 THEN asset_number "
+    "WHEN 2 THEN receipt_number ELSE vtr_number END AS value, auction_id FROM bids) "
+    "WHERE value <> '' AND value >= ?2 AND (?3 IS NULL OR value < ?3) ORDER BY value, auction_id LIMIT ?4;",
+    // SumByGroup: ?1 picks the group column in BidColumnStore::GroupColumn order and ?2
+    // the numeric column in BidColumnStore::NumericColumn order
+    "SELECT CASE ?1 WHEN 0 THEN department WHEN 1 THEN pay_status WHEN 2 THEN fund ELSE business_unit END AS value, "
+    "TOTAL(CASE ?2 WHEN 0 THEN winning_bid WHEN 1 THEN cc_fee WHEN 2 THEN fee_percent WHEN 3 THEN auction_fee_subtotal "
+    "WHEN 4 THEN auction_fee_total WHEN 5 THEN cap WHEN 6 THEN expenses ELSE net_sales END) FROM bids GROUP BY value;",
+    // SearchInventory
+    "SELECT * FROM bids WHERE inventory_id LIKE ? ESCAPE '\\';"
+};
+
+const char* const StatementCache::statementNames[StatementCount] = {
+    "selectAllBids",
+    "insertBid",
+    "selectBid",
+    "updateBid",
+    "deleteBid",
+    "insertUser",
+    "selectUser",
+    "enableMFA",
+    "selectMFAEnabled",
+    "selectTOTPSecret",
+    "beginTransaction",
+    "commitTransaction",
+    "rollbackTransaction",
+    "selectGeneration",
+    "countBids",
+    "selectBidPage",
+    "searchTitles",
+    "completeIdentifier",
+    "sumByGroup",
+    "searchInventory"
+};
+
+StatementCache::StatementCache() {
+    for (sqlite3_stmt*& stmt : statements) {
+        stmt = nullptr;
+    }
+}
+
+StatementCache::~StatementCache() {
+    Finalize();
+}
+
+// Compile every statement against the given connection
+void StatementCache::Prepare(sqlite3* db) {
+    Finalize();
+
+    for (int i = 0; i < StatementCount; i++) {
+        auto start = std::chrono::steady_clock::now();
+        int rc = sqlite3_prepare_v3(db, sqlText[i], -1, SQLITE_PREPARE_PERSISTENT, &statements[i], nullptr);
+        counters[i].prepareNanos += nanosSince(start);
+
+        if (rc != SQLITE_OK) {
+            std::string error = "Failed to prepare statement " + std::string(statementNames[i]) + ": " + sqlite3_errmsg(db);
+            Finalize();
+            throw std::runtime_error(error);
+        }
+    }
+}
+
+// Release every compiled statement
+void StatementCache::Finalize() {
+    for (sqlite3_stmt*& stmt : statements) {
+        if (stmt) {
+            sqlite3_finalize(stmt);
+            stmt = nullptr;
+        }
+    }
+}
+
+// Get a handle to a cached statement
+StatementCache::Handle StatementCache::Acquire(StatementId id) {
+    if (statements[id] == nullptr) {
+        throw std::runtime_error("Statement " + std::string(statementNames[id]) + " is not prepared");
+    }
+    counters[id].executions++;
+    return Handle(statements[id], this, id);
+}
+
+// Current timing counters for every statement
+std::vector<StatementCache::Timing> StatementCache::Timings() const {
+    std::vector<Timing> timings;
+    for (int i = 0; i < StatementCount; i++) {
+        Timing timing;
+        timing.name = statementNames[i];
+        timing.prepareNanos = counters[i].prepareNanos.load();
+        timing.executions = counters[i].executions.load();
+        timing.steps = counters[i].steps.load();
+        timing.stepNanos = counters[i].stepNanos.load();
+        timings.push_back(timing);
+    }
+    return timings;
+}
+
+/*
+** HANDLE
+*/
+
+StatementCache::Handle::Handle(sqlite3_stmt* aStmt, StatementCache* aCache, StatementId anId)
+    : stmt(aStmt), cache(aCache), id(anId) {}
+
+StatementCache::Handle::Handle(Handle&& other) noexcept
+    : stmt(other.stmt), cache(other.cache), id(other.id) {
+    other.stmt = nullptr;
+}
+
+StatementCache::Handle::~Handle() {
+    if (stmt) {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    }
+}
+
+void StatementCache::Handle::BindText(int index, const std::string& value) {
+    sqlite3_bind_text(stmt, index, value.c_str(), static_cast<int>(value.size()), SQLITE_STATIC);
+}
+
+void StatementCache::Handle::BindText(int index, const char* value) {
+    sqlite3_bind_text(stmt, index, value, -1, SQLITE_STATIC);
+}
+
+void StatementCache::Handle::BindDouble(int index, double value) {
+    sqlite3_bind_double(stmt, index, value);
+}
+
+void StatementCache::Handle::BindInt(int index, int value) {
+    sqlite3_bind_int(stmt, index, value);
+}
+
+void StatementCache::Handle::BindInt64(int index, int64_t value) {
+    sqlite3_bind_int64(stmt, index, value);
+}
+
+// Step the statement, recording the time spent
+int StatementCache::Handle::Step() {
+    auto start = std::chrono::steady_clock::now();
+    int rc = sqlite3_step(stmt);
+    cache->counters[id].stepNanos += nanosSince(start);
+    cache->counters[id].steps++;
+    return rc;
+}
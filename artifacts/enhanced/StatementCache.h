@@ -0,0 +1,122 @@
+/*
+ * File: StatementCache.h
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file defines the StatementCache class, which compiles every fixed SQL
+ * statement used by the DatabaseManager once, when the database is opened, and
+ * hands out RAII handles to them. A handle resets the statement and clears its
+ * bindings when it goes out of scope, so early returns and exceptions can never
+ * leave a statement half-stepped. The cache also keeps per-statement counters for
+ * prepare and step time so the effect of caching can be measured.
+ *
+ * Dependencies:
+ * - sqlite3 for database operations
+ *
+ */
+
+#pragma once
+#include <sqlite3.h>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+class StatementCache {
+public:
+    // Every statement the cache knows about
+    enum StatementId {
+        SelectAllBids,
+        InsertBid,
+        SelectBid,
+        UpdateBid,
+        DeleteBid,
+        InsertUser,
+        SelectUser,
+        EnableMFA,
+        SelectMFAEnabled,
+        SelectTOTPSecret,
+        BeginTransaction,
+        CommitTransaction,
+        RollbackTransaction,
+        SelectGeneration,
+        CountBids,
+        SelectBidPage,
+        SearchTitles,
+        CompleteIdentifier,
+        SumByGroup,
+        SearchInventory,
+        StatementCount
+    };
+
+    // Snapshot of the timing counters for one statement
+    struct Timing {
+        std::string name;
+        uint64_t prepareNanos;
+        uint64_t executions;
+        uint64_t steps;
+        uint64_t stepNanos;
+    };
+
+    // RAII handle to a cached statement. Resets the statement on destruction.
+    class Handle {
+    private:
+        sqlite3_stmt* stmt;
+        StatementCache* cache;
+        StatementId id;
+
+    public:
+        Handle(sqlite3_stmt* aStmt, StatementCache* aCache, StatementId anId);
+        Handle(Handle&& other) noexcept;
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+        ~Handle();
+
+        // Bind helpers; parameter indexes start at 1 as in sqlite3_bind_*
+        void BindText(int index, const std::string& value);
+        void BindText(int index, const char* value);
+        void BindDouble(int index, double value);
+        void BindInt(int index, int value);
+        void BindInt64(int index, int64_t value);
+
+        // Step the statement, recording the time spent
+        int Step();
+
+        sqlite3_stmt* get() const { return stmt; }
+    };
+
+    StatementCache();
+    ~StatementCache();
+
+    // Compile every statement against the given connection
+    void Prepare(sqlite3* db);
+
+    // Release every compiled statement
+    void Finalize();
+
+    // Get a handle to a cached statement
+    Handle Acquire(StatementId id);
+
+    // Current timing counters for every statement
+    std::vector<Timing> Timings() const;
+
+private:
+    // Counters are atomic so they can be read while other threads execute statements
+    struct Counters {
+        std::atomic<uint64_t> prepareNanos;
+        std::atomic<uint64_t> executions;
+        std::atomic<uint64_t> steps;
+        std::atomic<uint64_t> stepNanos;
+
+        Counters() : prepareNanos(0), executions(0), steps(0), stepNanos(0) {}
+    };
+
+    sqlite3_stmt* statements[StatementCount];
+    Counters counters[StatementCount];
+
+    static const char* const sqlText[StatementCount];
+    static const char* const statementNames[StatementCount];
+};
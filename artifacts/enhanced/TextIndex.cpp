@@ -0,0 +1,486 @@
+/*
+ * File: TextIndex.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file implements the TextIndex class: tokenizing, incremental maintenance of
+ * the compressed posting lists, and ranked AND/prefix search.
+ *
+ * Dependencies:
+ * - TextIndex.h
+ *
+ */
+
+#include "TextIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+    // BM25 parameters: term frequency saturation and length normalization
+    const double bm25K1 = 1.2;
+    const double bm25B = 0.75;
+
+    // Longest word kept; longer runs are cut, which only matters for junk text
+    const size_t maxTermLength = 64;
+
+    void appendVarint(std::vector<uint8_t>& bytes, uint32_t value) {
+        while (value >= 0x80) {
+            bytes.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back(static_cast<uint8_t>(value));
+    }
+
+    uint32_t readVarint(const std::vector<uint8_t>& bytes, size_t& offset) {
+        uint32_t value = 0;
+        int shift = 0;
+        uint8_t byte;
+        do {
+            byte = bytes[offset++];
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        return value;
+    }
+
+    // FNV-1a hash of a text, to notice updates that leave it unchanged
+    uint64_t hashText(std::string_view text) {
+        uint64_t h = 14695981039346656037ULL;
+        for (unsigned char c : text) {
+            h ^= c;
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    bool isWordByte(unsigned char c) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 0x80;
+    }
+}
+
+TextIndex::TextIndex(Field aField) : field(aField), liveCount(0), liveLength(0) {}
+
+// Lowercase words of letters and digits
+std::vector<std::string> TextIndex::Tokenize(std::string_view text) {
+    std::vector<std::string> tokens;
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && !isWordByte(static_cast<unsigned char>(text[i]))) {
+            i++;
+        }
+        size_t start = i;
+        while (i < text.size() && isWordByte(static_cast<unsigned char>(text[i]))) {
+            i++;
+        }
+        if (i > start) {
+            std::string token(text.substr(start, std::min(i - start, maxTermLength)));
+            for (char& c : token) {
+                if (c >= 'A' && c <= 'Z') {
+                    c = static_cast<char>(c - 'A' + 'a');
+                }
+            }
+            tokens.push_back(std::move(token));
+        }
+    }
+    return tokens;
+}
+
+// Index a bid's text, replacing what was indexed for its auction ID before
+void TextIndex::Add(const Bid& bid) {
+    const std::string& text = field(bid);
+    uint64_t textHash = hashText(text);
+
+    const uint32_t* existing = documentOf.Find(bid.auctionId);
+    if (existing != nullptr) {
+        if (documents[*existing].textHash == textHash) {
+            return;
+        }
+        Remove(bid.auctionId);
+    }
+    addDocument(bid.auctionId, text, textHash, true);
+}
+
+// Forget a bid
+void TextIndex::Remove(const std::string& auctionId) {
+    const uint32_t* found = documentOf.Find(auctionId);
+    if (found == nullptr) {
+        return;
+    }
+
+    liveCount--;
+    liveLength -= lengths[*found];
+    lengths[*found] = 0;
+    documentOf.Erase(auctionId);
+
+    // Dead documents cost space and decoding time until the lists are rewritten
+    size_t deadCount = documents.size() - liveCount;
+    if (deadCount > 1024 && deadCount > liveCount) {
+        compact();
+    }
+}
+
+// Replace the contents with every bid of a snapshot
+void TextIndex::Build(const BidSnapshot& snapshot) {
+    TextIndex built(field);
+    built.documents.reserve(snapshot.size());
+    built.documentOf.Reserve(snapshot.size());
+    for (size_t row = 0; row < snapshot.size(); row++) {
+        const Bid& bid = snapshot[row];
+        const std::string& text = field(bid);
+        built.addDocument(bid.auctionId, text, hashText(text), false);
+    }
+
+    std::vector<PostingList>& builtLists = built.lists;
+    std::sort(built.sortedTerms.begin(), built.sortedTerms.end(), [&builtLists](uint32_t a, uint32_t b) {
+        return builtLists[a].term < builtLists[b].term;
+    });
+    Swap(built);
+}
+
+// Exchange contents with another index
+void TextIndex::Swap(TextIndex& other) {
+    std::swap(field, other.field);
+    documents.swap(other.documents);
+    lengths.swap(other.lengths);
+    std::swap(documentOf, other.documentOf);
+    std::swap(liveCount, other.liveCount);
+    std::swap(liveLength, other.liveLength);
+    lists.swap(other.lists);
+    std::swap(listOf, other.listOf);
+    sortedTerms.swap(other.sortedTerms);
+}
+
+// Number of indexed documents
+size_t TextIndex::Size() const {
+    return liveCount;
+}
+
+// Index a document's text under a new document number
+void TextIndex::addDocument(const std::string& auctionId, const std::string& text, uint64_t textHash, bool keepSorted) {
+    std::vector<std::string> tokens = Tokenize(text);
+    uint32_t documentNumber = static_cast<uint32_t>(documents.size());
+    uint16_t length = static_cast<uint16_t>(std::min<size_t>(tokens.size(), UINT16_MAX));
+    documents.push_back(Document{ auctionId, textHash });
+    lengths.push_back(length);
+    documentOf.Insert(auctionId, documentNumber);
+    liveCount++;
+    liveLength += length;
+
+    // One posting per distinct word, with the number of times it occurs
+    std::sort(tokens.begin(), tokens.end());
+    for (size_t i = 0; i < tokens.size();) {
+        size_t j = i + 1;
+        while (j < tokens.size() && tokens[j] == tokens[i]) {
+            j++;
+        }
+
+        uint32_t listNumber;
+        const uint32_t* found = listOf.Find(tokens[i]);
+        if (found != nullptr) {
+            listNumber = *found;
+        }
+        else {
+            listNumber = static_cast<uint32_t>(lists.size());
+            lists.push_back(PostingList{ tokens[i], {}, {}, 0, 0 });
+            listOf.Insert(tokens[i], listNumber);
+            if (keepSorted) {
+                auto position = std::lower_bound(sortedTerms.begin(), sortedTerms.end(), tokens[i], [this](uint32_t list, const std::string& term) {
+                    return lists[list].term < term;
+                });
+                sortedTerms.insert(position, listNumber);
+            }
+            else {
+                sortedTerms.push_back(listNumber);
+            }
+        }
+
+        PostingList& list = lists[listNumber];
+        if (list.count % blockSize == 0) {
+            list.skips.push_back(Skip{ documentNumber, list.lastDocument, static_cast<uint32_t>(list.bytes.size()) });
+        }
+        appendVarint(list.bytes, documentNumber - list.lastDocument);
+        appendVarint(list.bytes, static_cast<uint32_t>(j - i));
+        list.lastDocument = documentNumber;
+        list.count++;
+        i = j;
+    }
+}
+
+// Rewrite the posting lists without dead documents and renumber the live ones
+void TextIndex::compact() {
+    const uint32_t dead = 0xFFFFFFFFu;
+    std::vector<uint32_t> renumbered(documents.size(), dead);
+    std::vector<Document> liveDocuments;
+    std::vector<uint16_t> liveLengths;
+    liveDocuments.reserve(liveCount);
+    liveLengths.reserve(liveCount);
+    for (size_t i = 0; i < documents.size(); i++) {
+        const uint32_t* live = documentOf.Find(documents[i].auctionId);
+        if (live != nullptr && *live == i) {
+            renumbered[i] = static_cast<uint32_t>(liveDocuments.size());
+            liveDocuments.push_back(std::move(documents[i]));
+            liveLengths.push_back(lengths[i]);
+        }
+    }
+
+    // Live documents keep their relative order, so every list stays sorted
+    std::vector<PostingList> liveLists;
+    for (const PostingList& list : lists) {
+        PostingList rewritten{ list.term, {}, {}, 0, 0 };
+        for (Cursor cursor(list); !cursor.Done(); cursor.Next()) {
+            uint32_t documentNumber = renumbered[cursor.Document()];
+            if (documentNumber == dead) {
+                continue;
+            }
+            if (rewritten.count % blockSize == 0) {
+                rewritten.skips.push_back(Skip{ documentNumber, rewritten.lastDocument, static_cast<uint32_t>(rewritten.bytes.size()) });
+            }
+            appendVarint(rewritten.bytes, documentNumber - rewritten.lastDocument);
+            appendVarint(rewritten.bytes, cursor.Frequency());
+            rewritten.lastDocument = documentNumber;
+            rewritten.count++;
+        }
+        if (rewritten.count > 0) {
+            liveLists.push_back(std::move(rewritten));
+        }
+    }
+
+    documents.swap(liveDocuments);
+    lengths.swap(liveLengths);
+    documentOf.Clear();
+    documentOf.Reserve(documents.size());
+    for (size_t i = 0; i < documents.size(); i++) {
+        documentOf.Insert(documents[i].auctionId, static_cast<uint32_t>(i));
+    }
+
+    // Lists were kept in their old order, so only the ones that emptied are gone
+    lists.swap(liveLists);
+    listOf.Clear();
+    sortedTerms.clear();
+    for (size_t i = 0; i < lists.size(); i++) {
+        listOf.Insert(lists[i].term, static_cast<uint32_t>(i));
+        sortedTerms.push_back(static_cast<uint32_t>(i));
+    }
+    std::sort(sortedTerms.begin(), sortedTerms.end(), [this](uint32_t a, uint32_t b) {
+        return lists[a].term < lists[b].term;
+    });
+}
+
+// Up to limit documents containing every word of the query, best first
+std::vector<TextIndex::Match> TextIndex::Search(std::string_view query, size_t limit) const {
+    std::vector<Match> matches;
+    std::vector<std::string> words = Tokenize(query);
+    if (words.empty() || limit == 0) {
+        return matches;
+    }
+
+    // Each query word becomes a group of posting lists: its own list, or for the last
+    // word, the lists of every term it is a prefix of
+    struct Group {
+        std::vector<const PostingList*> lists;
+        size_t postings;
+    };
+    std::vector<Group> groups;
+    for (size_t w = 0; w < words.size(); w++) {
+        const std::string& word = words[w];
+        bool prefix = (w + 1 == words.size());
+        if (!prefix && std::find(words.begin() + w + 1, words.end() - 1, word) != words.end() - 1) {
+            continue;  // A repeated whole word adds nothing to an AND
+        }
+
+        Group group{ {}, 0 };
+        if (prefix) {
+            auto it = std::lower_bound(sortedTerms.begin(), sortedTerms.end(), word, [this](uint32_t list, const std::string& term) {
+                return lists[list].term < term;
+            });
+            for (; it != sortedTerms.end() && lists[*it].term.compare(0, word.size(), word) == 0; ++it) {
+                group.lists.push_back(&lists[*it]);
+                group.postings += lists[*it].count;
+            }
+        }
+        else {
+            const uint32_t* found = listOf.Find(word);
+            if (found != nullptr) {
+                group.lists.push_back(&lists[*found]);
+                group.postings = lists[*found].count;
+            }
+        }
+        if (group.lists.empty()) {
+            return matches;
+        }
+        groups.push_back(std::move(group));
+    }
+
+    // Intersect starting from the rarest word, so later words are only probed
+    std::sort(groups.begin(), groups.end(), [](const Group& a, const Group& b) {
+        return a.postings < b.postings;
+    });
+
+    Ranker ranker(*this);
+
+    // Candidates from the first group, scored; a document matching several terms of a
+    // prefix counts its best one
+    std::vector<std::pair<uint32_t, double>> candidates;
+    candidates.reserve(groups[0].postings);
+    for (const PostingList* list : groups[0].lists) {
+        double weight = ranker.Weight(*list);
+        size_t merged = candidates.size();
+        for (Cursor cursor(*list); !cursor.Done(); cursor.Next()) {
+            uint16_t length = lengths[cursor.Document()];
+            if (length > 0) {
+                candidates.emplace_back(cursor.Document(), ranker.Score(weight, cursor.Frequency(), length));
+            }
+        }
+        // Each list is in document order, so merging keeps the whole run sorted
+        std::inplace_merge(candidates.begin(), candidates.begin() + merged, candidates.end());
+    }
+    if (groups[0].lists.size() > 1) {
+        size_t kept = 0;
+        for (size_t i = 0; i < candidates.size(); i++) {
+            if (kept > 0 && candidates[kept - 1].first == candidates[i].first) {
+                candidates[kept - 1].second = std::max(candidates[kept - 1].second, candidates[i].second);
+            }
+            else {
+                candidates[kept++] = candidates[i];
+            }
+        }
+        candidates.resize(kept);
+    }
+
+    for (size_t g = 1; g < groups.size() && !candidates.empty(); g++) {
+        const Group& group = groups[g];
+        std::vector<double> best(candidates.size(), 0.0);
+
+        // Probing skips whole blocks, but reading a list straight through is cheaper
+        // once the probes would touch most of it
+        size_t probeCost = candidates.size() * group.lists.size() * (blockSize / 2);
+        for (const PostingList* list : group.lists) {
+            double weight = ranker.Weight(*list);
+            Cursor cursor(*list);
+            if (probeCost < group.postings) {
+                for (size_t c = 0; c < candidates.size(); c++) {
+                    cursor.Seek(candidates[c].first);
+                    if (cursor.Done()) {
+                        break;
+                    }
+                    if (cursor.Document() == candidates[c].first) {
+                        best[c] = std::max(best[c], ranker.Score(weight, cursor.Frequency(), lengths[cursor.Document()]));
+                    }
+                }
+            }
+            else {
+                size_t c = 0;
+                while (!cursor.Done() && c < candidates.size()) {
+                    if (cursor.Document() < candidates[c].first) {
+                        cursor.Next();
+                    }
+                    else if (cursor.Document() > candidates[c].first) {
+                        c++;
+                    }
+                    else {
+                        best[c] = std::max(best[c], ranker.Score(weight, cursor.Frequency(), lengths[cursor.Document()]));
+                        cursor.Next();
+                        c++;
+                    }
+                }
+            }
+        }
+
+        size_t kept = 0;
+        for (size_t c = 0; c < candidates.size(); c++) {
+            if (best[c] > 0) {
+                candidates[kept++] = std::make_pair(candidates[c].first, candidates[c].second + best[c]);
+            }
+        }
+        candidates.resize(kept);
+    }
+
+    // Best scores first; ties go to the document indexed first
+    auto better = [](const std::pair<uint32_t, double>& a, const std::pair<uint32_t, double>& b) {
+        if (a.second != b.second) {
+            return a.second > b.second;
+        }
+        return a.first < b.first;
+    };
+
+    size_t count = std::min(limit, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), better);
+
+    matches.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        matches.push_back(Match{ documents[candidates[i].first].auctionId, candidates[i].second });
+    }
+    return matches;
+}
+
+/*
+** RANKER
+*/
+
+TextIndex::Ranker::Ranker(const TextIndex& index) {
+    documentCount = static_cast<double>(index.liveCount);
+    double averageLength = (index.liveCount > 0) ? static_cast<double>(index.liveLength) / index.liveCount : 1.0;
+    lengthBase = bm25K1 * (1.0 - bm25B);
+    lengthScale = bm25K1 * bm25B / std::max(averageLength, 1.0);
+}
+
+// Weight of a term, from how many documents contain it
+double TextIndex::Ranker::Weight(const PostingList& list) const {
+    // Counts include postings of dead documents until the next compaction, which
+    // only shifts the weights slightly
+    double df = std::min(static_cast<double>(list.count), documentCount);
+    double idf = std::log(1.0 + (documentCount - df + 0.5) / (df + 0.5));
+    return idf * (bm25K1 + 1.0);
+}
+
+/*
+** CURSOR
+*/
+
+TextIndex::Cursor::Cursor(const PostingList& aList)
+    : list(&aList), index(0), offset(0), document(0), frequency(0) {
+    if (!Done()) {
+        decode(0);
+    }
+}
+
+// Read the posting at offset, whose delta is relative to previous
+void TextIndex::Cursor::decode(uint32_t previous) {
+    document = previous + readVarint(list->bytes, offset);
+    frequency = readVarint(list->bytes, offset);
+}
+
+void TextIndex::Cursor::Next() {
+    index++;
+    if (!Done()) {
+        decode(document);
+    }
+}
+
+// Advance to the first posting at or after target
+void TextIndex::Cursor::Seek(uint32_t target) {
+    if (Done() || document >= target) {
+        return;
+    }
+
+    // Jump to the last block starting at or before target, if that is ahead of us
+    size_t block = index / blockSize;
+    auto next = std::upper_bound(list->skips.begin() + block + 1, list->skips.end(), target, [](uint32_t value, const Skip& skip) {
+        return value < skip.firstDocument;
+    });
+    size_t targetBlock = static_cast<size_t>(next - list->skips.begin()) - 1;
+    if (targetBlock > block) {
+        const Skip& skip = list->skips[targetBlock];
+        index = static_cast<uint32_t>(targetBlock * blockSize);
+        offset = skip.offset;
+        decode(skip.previousDocument);
+    }
+
+    while (!Done() && document < target) {
+        Next();
+    }
+}
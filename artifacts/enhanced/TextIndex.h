@@ -0,0 +1,158 @@
+/*
+ * File: TextIndex.h
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file defines the TextIndex class, an inverted index from words to the bids
+ * whose text contains them. It is used for keyword search over auction titles, so a
+ * query such as "dell laptop" reads two posting lists instead of scanning every title.
+ *
+ * Text is split into lowercase words of letters and digits. Each word has a posting
+ * list of document numbers in increasing order, stored as variable-length deltas with
+ * a skip entry at the start of every block, so lists stay small and an intersection
+ * can jump over blocks that cannot contain the next candidate. Document numbers are
+ * handed out in insertion order; a removed document is only marked dead, and the
+ * lists are rewritten without dead documents once they outnumber the live ones.
+ *
+ * A search matches the documents that contain every query word, treating the last
+ * word as a prefix so that partially typed queries work, and ranks them with BM25.
+ *
+ * The class is not thread-safe; the owner serializes changes against searches.
+ *
+ * Dependencies:
+ * - HashIndex.h for the word and auction ID dictionaries
+ * - BidSnapshot.h for bulk builds
+ *
+ */
+
+#pragma once
+#include "HashIndex.h"
+#include "BidSnapshot.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class TextIndex {
+public:
+    // A matching document and its relevance; higher scores rank first
+    struct Match {
+        std::string auctionId;
+        double score;
+    };
+
+    // Which bid field a TextIndex covers
+    typedef const std::string& (*Field)(const Bid& bid);
+
+    explicit TextIndex(Field aField);
+
+    // Index a bid's text, replacing what was indexed for its auction ID before
+    void Add(const Bid& bid);
+
+    // Forget a bid; does nothing if it is not indexed
+    void Remove(const std::string& auctionId);
+
+    // Replace the contents with every bid of a snapshot
+    void Build(const BidSnapshot& snapshot);
+
+    // Exchange contents with another index in constant time
+    void Swap(TextIndex& other);
+
+    // Up to limit documents containing every word of the query, best first
+    std::vector<Match> Search(std::string_view query, size_t limit) const;
+
+    // Number of indexed documents
+    size_t Size() const;
+
+    // Lowercase words of letters and digits; bytes of multi-byte UTF-8 characters
+    // count as letters so that accented words stay whole
+    static std::vector<std::string> Tokenize(std::string_view text);
+
+private:
+    struct Document {
+        std::string auctionId;
+        uint64_t textHash;  // Lets an update that keeps the text skip reindexing
+    };
+
+    // Start of a block of postings
+    struct Skip {
+        uint32_t firstDocument;
+        uint32_t previousDocument;  // The delta base for the block's first posting
+        uint32_t offset;
+    };
+
+    struct PostingList {
+        std::string term;
+        std::vector<uint8_t> bytes;  // Per posting: varint document delta, varint term frequency
+        std::vector<Skip> skips;     // One per block of blockSize postings
+        uint32_t count;              // Postings, including those of dead documents
+        uint32_t lastDocument;
+    };
+
+    // Reads one posting list in document order
+    class Cursor {
+    public:
+        explicit Cursor(const PostingList& aList);
+        bool Done() const { return index >= list->count; }
+        uint32_t Document() const { return document; }
+        uint32_t Frequency() const { return frequency; }
+        void Next();
+
+        // Advance to the first posting at or after target
+        void Seek(uint32_t target);
+
+    private:
+        const PostingList* list;
+        uint32_t index;
+        size_t offset;
+        uint32_t document;
+        uint32_t frequency;
+
+        void decode(uint32_t previous);
+    };
+
+    static const uint32_t blockSize = 64;
+
+    // BM25 with the collection statistics of one search folded into constants
+    class Ranker {
+    public:
+        explicit Ranker(const TextIndex& index);
+
+        // Weight of a term, from how many documents contain it
+        double Weight(const PostingList& list) const;
+
+        double Score(double weight, uint32_t frequency, uint16_t length) const {
+            double tf = static_cast<double>(frequency);
+            return weight * tf / (tf + lengthBase + lengthScale * length);
+        }
+
+    private:
+        double documentCount;
+        double lengthBase;
+        double lengthScale;
+    };
+
+    Field field;
+    std::vector<Document> documents;
+    // Words per document, capped, or 0 once it is removed. A document without words has
+    // no postings, so the search loops can take 0 to mean removed. Kept apart from
+    // documents so scoring reads two bytes per posting rather than a whole Document.
+    std::vector<uint16_t> lengths;
+    HashIndex<uint32_t> documentOf;   // Auction ID to live document
+    size_t liveCount;
+    uint64_t liveLength;              // Total of lengths over live documents
+    std::vector<PostingList> lists;
+    HashIndex<uint32_t> listOf;       // Term to posting list
+    std::vector<uint32_t> sortedTerms;  // Posting lists ordered by term, for prefix lookups
+
+    // Index a document's text under a new document number. With keepSorted false the
+    // caller re-sorts sortedTerms once it has added everything.
+    void addDocument(const std::string& auctionId, const std::string& text, uint64_t textHash, bool keepSorted);
+
+    // Rewrite the posting lists without dead documents and renumber the live ones
+    void compact();
+};
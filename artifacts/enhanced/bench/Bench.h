@@ -0,0 +1,64 @@
+/*
+ * File: Bench.h
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file holds the small helpers shared by the benchmarks: a stopwatch, the
+ * optional size argument every benchmark takes, and one line of output per
+ * measurement, per item or per byte.
+ *
+ * Dependencies: None
+ *
+ */
+
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstddef>
+
+namespace bench {
+
+    class Stopwatch {
+    private:
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        Stopwatch() : start(std::chrono::steady_clock::now()) {}
+
+        void Restart() {
+            start = std::chrono::steady_clock::now();
+        }
+
+        double Seconds() const {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    };
+
+    // The first argument, if given, replaces the default size
+    inline size_t Count(int argc, char** argv, size_t fallback) {
+        if (argc > 1) {
+            char* end = nullptr;
+            unsigned long long value = std::strtoull(argv[1], &end, 10);
+            if (end != argv[1] && *end == '\0' && value > 0) {
+                return static_cast<size_t>(value);
+            }
+            std::fprintf(stderr, "usage: %s [count]\n", argv[0]);
+            std::exit(2);
+        }
+        return fallback;
+    }
+
+    // Total time and time per item for one measurement
+    inline void Report(const char* name, size_t items, double seconds) {
+        std::printf("%-40s %10.2f ms %10.1f ns/item\n", name, seconds * 1e3, items ? seconds * 1e9 / items : 0.0);
+    }
+
+    // Total time and throughput for one measurement over a number of bytes
+    inline void ReportBytes(const char* name, size_t bytes, double seconds) {
+        std::printf("%-40s %10.2f ms %10.1f MB/s\n", name, seconds * 1e3, seconds > 0 ? bytes / seconds / 1e6 : 0.0);
+    }
+}
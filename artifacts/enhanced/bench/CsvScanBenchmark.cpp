@@ -0,0 +1,130 @@
+/*
+ * File: CsvScanBenchmark.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file measures how fast CSV lines are split into fields, in bytes per
+ * second, over a synthetic export (200k rows by default) that includes quoted
+ * multi-item inventory lists. The baseline is the parser's original loop, which
+ * reads every byte with the bounds-checked at() and copies each field out with
+ * substr. It is compared against every separator scanning kernel this CPU can run,
+ * splitting into views as the mapped reader does. Every kernel must find the same
+ * fields as the baseline.
+ *
+ * Dependencies:
+ * - CSVparser for the kernels under test
+ * - SyntheticBids.h for the data
+ * - Bench.h for timing and output
+ *
+ */
+
+#include "CSVparser.h"
+#include "SyntheticBids.h"
+#include "Bench.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    // The original Parser::parseContent loop for one line
+    void splitBaseline(const std::string& line, std::vector<std::string>& fields) {
+        bool quoted = false;
+        int tokenStart = 0;
+        unsigned int i = 0;
+        fields.clear();
+
+        for (; i != line.length(); i++) {
+            if (line.at(i) == '"')
+                quoted = ((quoted) ? (false) : (true));
+            else if (line.at(i) == ',' && !quoted) {
+                fields.push_back(line.substr(tokenStart, i - tokenStart));
+                tokenStart = i + 1;
+            }
+        }
+        fields.push_back(line.substr(tokenStart, line.length() - tokenStart));
+    }
+
+    // Repeat a pass over every line until at least this long has been measured
+    const double minSeconds = 0.5;
+}
+
+int main(int argc, char** argv) {
+    size_t rows = bench::Count(argc, argv, 200000);
+
+    const char* path = "CsvScanBenchmark.csv";
+    synthetic::WriteCSV(path, rows);
+    std::vector<std::string> lines;
+    size_t bytes = 0;
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::string line;
+        while (std::getline(in, line)) {
+            bytes += line.size() + 1;
+            lines.push_back(std::move(line));
+        }
+    }
+    std::remove(path);
+    std::printf("%zu lines, %.1f MB\n", lines.size(), bytes / 1e6);
+
+    // Field count of every line, from the baseline, to check the kernels against
+    std::vector<size_t> expected(lines.size());
+    size_t fieldTotal = 0;
+    {
+        std::vector<std::string> fields;
+        bench::Stopwatch stopwatch;
+        size_t passes = 0;
+        do {
+            for (size_t i = 0; i < lines.size(); i++) {
+                splitBaseline(lines[i], fields);
+                expected[i] = fields.size();
+            }
+            passes++;
+        } while (stopwatch.Seconds() < minSeconds);
+        bench::ReportBytes("original loop (at() and substr)", bytes * passes, stopwatch.Seconds());
+        for (size_t count : expected) {
+            fieldTotal += count;
+        }
+    }
+
+    const struct {
+        csv::ScanKernel kernel;
+        const char* name;
+    } kernels[] = {
+        { csv::ScanKernel::Scalar, "scalar kernel" },
+        { csv::ScanKernel::SSE2, "SSE2 kernel" },
+        { csv::ScanKernel::AVX2, "AVX2 kernel" },
+        { csv::ScanKernel::Best, "kernel picked for this CPU" },
+    };
+    std::vector<std::string_view> fields;
+    for (const auto& kernel : kernels) {
+        if (!csv::scanKernelSupported(kernel.kernel)) {
+            std::printf("%-40s not supported on this CPU\n", kernel.name);
+            continue;
+        }
+
+        bench::Stopwatch stopwatch;
+        size_t passes = 0;
+        size_t found = 0;
+        do {
+            found = 0;
+            for (const std::string& line : lines) {
+                csv::splitFields(line, ',', fields, kernel.kernel);
+                found += fields.size();
+            }
+            passes++;
+        } while (stopwatch.Seconds() < minSeconds);
+        bench::ReportBytes(kernel.name, bytes * passes, stopwatch.Seconds());
+
+        if (found != fieldTotal) {
+            std::fprintf(stderr, "%s found %zu fields, expected %zu\n", kernel.name, found, fieldTotal);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+/*
+ * File: NodePoolBenchmark.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file measures loading and tearing down a list of synthetic bids (1M by
+ * default) with list nodes allocated one at a time on the heap, as LinkedList did
+ * before it had a NodePool, and with nodes carved out of NodePool slabs. A third
+ * run loads and destroys a real LinkedList, which also maintains the hash and
+ * sorted indexes. The bid records are built before any timing starts, so only
+ * node allocation, linking and release are measured.
+ *
+ * Dependencies:
+ * - LinkedList and NodePool for the structures under test
+ * - SyntheticBids.h for the data
+ * - Bench.h for timing and output
+ *
+ */
+
+#include "LinkedList.h"
+#include "NodePool.h"
+#include "SyntheticBids.h"
+#include "Bench.h"
+#include <vector>
+#include <set>
+#include <cstdio>
+
+namespace {
+    // Same fields and size as a LinkedList node
+    struct Node {
+        BidPtr bid;
+        Node* next;
+        Node* prev;
+        std::multiset<int>::iterator sortedPosition;
+        uint32_t row;
+
+        explicit Node(BidPtr aBid) : bid(std::move(aBid)), next(nullptr), prev(nullptr), row(0) {}
+    };
+
+    // Link nodes from an allocator into a doubly linked list, then free them all from
+    // the head and let the allocator finish up, as a list destructor does
+    template <typename Allocate, typename Release, typename Finish>
+    void loadAndTearDown(const char* name, const std::vector<BidPtr>& bids, Allocate allocate, Release release, Finish finish) {
+        bench::Stopwatch stopwatch;
+        Node* head = nullptr;
+        Node* tail = nullptr;
+        for (const BidPtr& bid : bids) {
+            Node* node = allocate(bid);
+            node->prev = tail;
+            if (tail != nullptr) {
+                tail->next = node;
+            }
+            else {
+                head = node;
+            }
+            tail = node;
+        }
+        double load = stopwatch.Seconds();
+
+        stopwatch.Restart();
+        while (head != nullptr) {
+            Node* next = head->next;
+            release(head);
+            head = next;
+        }
+        finish();
+        double teardown = stopwatch.Seconds();
+
+        std::printf("%s\n", name);
+        bench::Report("  load", bids.size(), load);
+        bench::Report("  teardown", bids.size(), teardown);
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t count = bench::Count(argc, argv, 1000000);
+
+    std::vector<BidPtr> bids;
+    bids.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        bids.push_back(std::make_shared<const Bid>(synthetic::MakeBid(i)));
+    }
+    std::printf("%zu bids\n", count);
+
+    loadAndTearDown("heap nodes (before NodePool)", bids,
+        [](const BidPtr& bid) { return new Node(bid); },
+        [](Node* node) { delete node; },
+        []() {});
+
+    // LinkedList's destructor runs the node destructors and drops the slabs in one go
+    NodePool<Node> pool;
+    loadAndTearDown("NodePool nodes", bids,
+        [&pool](const BidPtr& bid) { return pool.Allocate(bid); },
+        [](Node* node) { node->~Node(); },
+        [&pool]() { pool.Clear(); });
+
+    {
+        bench::Stopwatch stopwatch;
+        LinkedList* list = new LinkedList();
+        for (const BidPtr& bid : bids) {
+            list->Append(bid);
+        }
+        double load = stopwatch.Seconds();
+
+        stopwatch.Restart();
+        delete list;
+        double teardown = stopwatch.Seconds();
+
+        std::printf("LinkedList (NodePool, hash and sorted indexes)\n");
+        bench::Report("  load", count, load);
+        bench::Report("  teardown", count, teardown);
+    }
+    return 0;
+}
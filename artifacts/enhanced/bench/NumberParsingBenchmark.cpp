@@ -0,0 +1,162 @@
+/*
+ * File: NumberParsingBenchmark.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file measures how fast the numeric columns of an export are converted, in
+ * nanoseconds per field, over a synthetic export the size of the eBid monthly sample
+ * (18k rows by default). The baseline is the import's original conversion, which
+ * copies each field into a std::string for std::stod and reports a bad value by
+ * throwing. It is compared against parseMoney and parsePercent on clean data and on
+ * the same data with one field in twenty replaced by text, where the baseline pays
+ * for an exception per bad field. Both must read the same values from clean data.
+ *
+ * Dependencies:
+ * - NumberParsing for the parsers under test
+ * - CSVparser for splitting the rows
+ * - SyntheticBids.h for the data
+ * - Bench.h for timing and output
+ *
+ */
+
+#include "NumberParsing.h"
+#include "CSVparser.h"
+#include "SyntheticBids.h"
+#include "Bench.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    // The import's conversion before NumberParsing: skip leading spaces and dollar
+    // signs, then std::stod, which throws if nothing is convertible
+    double amountBaseline(std::string_view field) {
+        if (field.empty()) {
+            return 0;
+        }
+        size_t start = field.find_first_not_of(" $");
+        if (start == std::string_view::npos) {
+            throw std::out_of_range("amount field has no digits");
+        }
+        return std::stod(std::string(field.substr(start)));
+    }
+
+    double percentBaseline(std::string_view field) {
+        return field.empty() ? 0 : std::stod(std::string(field));
+    }
+
+    // The numeric columns of the export, and whether each is a percentage
+    const struct {
+        size_t column;
+        bool percent;
+    } numericColumns[] = {
+        { 4, false }, { 5, false }, { 6, true }, { 7, false }, { 8, false }, { 16, false }, { 17, false }, { 18, false },
+    };
+
+    struct Field {
+        std::string text;
+        bool percent;
+    };
+
+    // Repeat a pass over every field until at least this long has been measured
+    const double minSeconds = 0.5;
+
+    // Convert every field with the original code, returning the sum and counting the rejects
+    double runBaseline(const std::vector<Field>& fields, size_t& rejected) {
+        double sum = 0;
+        rejected = 0;
+        for (const Field& field : fields) {
+            try {
+                sum += field.percent ? percentBaseline(field.text) : amountBaseline(field.text);
+            }
+            catch (const std::exception&) {
+                rejected++;
+            }
+        }
+        return sum;
+    }
+
+    double runParsers(const std::vector<Field>& fields, size_t& rejected) {
+        double sum = 0;
+        rejected = 0;
+        for (const Field& field : fields) {
+            double value = 0;
+            ParseStatus status = field.percent ? parsePercent(field.text, value) : parseMoney(field.text, value);
+            if (status == ParseStatus::Ok) {
+                sum += value;
+            }
+            else {
+                rejected++;
+            }
+        }
+        return sum;
+    }
+
+    template <typename Run>
+    double measure(const char* name, const std::vector<Field>& fields, size_t& rejected, Run run) {
+        double sum = 0;
+        size_t passes = 0;
+        bench::Stopwatch stopwatch;
+        do {
+            sum = run(fields, rejected);
+            passes++;
+        } while (stopwatch.Seconds() < minSeconds);
+        bench::Report(name, fields.size() * passes, stopwatch.Seconds());
+        return sum;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t rows = bench::Count(argc, argv, 18000);
+
+    const char* path = "NumberParsingBenchmark.csv";
+    synthetic::WriteCSV(path, rows);
+    std::vector<Field> clean;
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::string line;
+        std::vector<std::string_view> row;
+        std::getline(in, line);
+        while (std::getline(in, line)) {
+            csv::splitFields(line, ',', row);
+            for (const auto& numeric : numericColumns) {
+                clean.push_back({ std::string(row[numeric.column]), numeric.percent });
+            }
+        }
+    }
+    std::remove(path);
+
+    std::vector<Field> dirty = clean;
+    size_t dirtyCount = 0;
+    for (size_t i = 0; i < dirty.size(); i++) {
+        if (synthetic::mix(i) % 20 == 0) {
+            dirty[i].text = "N/A";
+            dirtyCount++;
+        }
+    }
+    std::printf("%zu rows, %zu fields, %zu dirty\n", rows, clean.size(), dirtyCount);
+
+    size_t rejected = 0;
+    double expected = measure("original stod, clean", clean, rejected, runBaseline);
+    double sum = measure("parseMoney/parsePercent, clean", clean, rejected, runParsers);
+    if (rejected != 0 || sum != expected) {
+        std::fprintf(stderr, "parsers read %.17g with %zu rejected, expected %.17g\n", sum, rejected, expected);
+        return 1;
+    }
+
+    measure("original stod, 5% dirty", dirty, rejected, runBaseline);
+    size_t baselineRejected = rejected;
+    measure("parseMoney/parsePercent, 5% dirty", dirty, rejected, runParsers);
+    if (rejected != dirtyCount || baselineRejected != dirtyCount) {
+        std::fprintf(stderr, "rejected %zu and %zu fields, expected %zu\n", baselineRejected, rejected, dirtyCount);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+/*
+ * File: QueryLatencyBenchmark.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file measures how the latency of a page of bids grows with the size of the
+ * table. Synthetic exports of 1k, 10k and 100k rows (up to the size given) are
+ * imported into a new database, and each query is timed two ways: repeated against
+ * an unchanged store, and as the first query after a write, when any order or
+ * snapshot built for the previous version of the store has to be rebuilt. The
+ * queries cover each plan: pages in auction ID order read from the sorted index,
+ * an equality filter, a range filter with a sort, and a sort alone.
+ *
+ * Dependencies:
+ * - DatabaseManager for the store under test
+ * - SyntheticBids.h for the data
+ * - Bench.h for timing and output
+ *
+ */
+
+#include "DatabaseManager.h"
+#include "SyntheticBids.h"
+#include "Bench.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+    const char* const databasePath = "QueryLatencyBenchmark.db";
+    const char* const csvPath = "QueryLatencyBenchmark.csv";
+    const size_t pageSize = 50;
+
+    // Repeat a query until at least this long has been measured
+    const double minSeconds = 0.2;
+    const int writes = 5;
+
+    void removeDatabase() {
+        for (const char* suffix : { "", "-wal", "-shm" }) {
+            std::remove((std::string(databasePath) + suffix).c_str());
+        }
+        std::remove("QueryLatencyBenchmark.store");
+    }
+
+    struct Case {
+        const char* name;
+        BidQuery query;
+        std::string cursor;
+    };
+
+    void measure(DatabaseManager& db, const Case& test, size_t rows) {
+        size_t passes = 0;
+        bench::Stopwatch stopwatch;
+        do {
+            BidPage page = db.getBidPage(test.query, test.cursor, pageSize);
+            if (page.bids.size() == 0) {
+                std::fprintf(stderr, "%s returned no bids\n", test.name);
+                std::exit(1);
+            }
+            passes++;
+        } while (stopwatch.Seconds() < minSeconds);
+        double repeated = stopwatch.Seconds() / passes;
+
+        // Change one bid, then time the next query on its own
+        double afterWrite = 0;
+        for (int i = 0; i < writes; i++) {
+            Bid bid = db.getBid(synthetic::AuctionId(rows / 2 + i));
+            bid.netSales += 1;
+            db.updateBid(bid);
+            stopwatch.Restart();
+            db.getBidPage(test.query, test.cursor, pageSize);
+            afterWrite += stopwatch.Seconds();
+        }
+        afterWrite /= writes;
+
+        std::printf("%8zu  %-36s %12.1f %12.1f\n", rows, test.name, repeated * 1e6, afterWrite * 1e6);
+    }
+
+    void run(size_t rows) {
+        removeDatabase();
+        synthetic::WriteCSV(csvPath, rows);
+        {
+            DatabaseManager db(databasePath);
+            db.init();
+            ImportSummary summary = db.importFromCSV(csvPath);
+            if (summary.imported != rows) {
+                std::fprintf(stderr, "imported %zu of %zu rows\n", summary.imported, rows);
+                std::exit(1);
+            }
+        }
+        std::remove(csvPath);
+
+        DatabaseManager db(databasePath);
+        db.init();
+
+        // The manager logs as it loads, so the table header follows the log
+        std::printf("%8s  %-36s %12s %12s\n", "rows", "query", "us/page", "after write");
+        std::vector<Case> cases(5);
+        cases[0].name = "auction ID, first page";
+        cases[1].name = "auction ID, middle page";
+        cases[1].cursor = db.getBidPage(cases[1].query, "", rows / 2).nextCursor;
+        cases[2].name = "department=ITS";
+        cases[2].query.AddFilter("department", "ITS");
+        cases[3].name = "winning bid 1000-2000, by -closeDate";
+        cases[3].query.AddFilter("minWinningBid", "1000");
+        cases[3].query.AddFilter("maxWinningBid", "2000");
+        cases[3].query.SetSort("-closeDate");
+        cases[4].name = "sorted by -netSales";
+        cases[4].query.SetSort("-netSales");
+
+        for (const Case& test : cases) {
+            measure(db, test, rows);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t largest = bench::Count(argc, argv, 100000);
+
+    for (size_t rows = std::min<size_t>(1000, largest); rows <= largest; rows *= 10) {
+        run(rows);
+    }
+    removeDatabase();
+    return 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * File: SortBenchmark.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file measures sorting synthetic bids (1M by default) by winningBid,
+ * closeDate and department three ways: LinkedList::Sort, LinkedList::ParallelSort
+ * with one thread per core (at least two, so the split and merge always run), and
+ * BidSnapshot::SortedOrder, which the listings use.
+ * Each list sort starts from a fresh copy of the unsorted list; copying is not
+ * timed. Every result is checked to be in order.
+ *
+ * Dependencies:
+ * - LinkedList and BidSnapshot for the sorts under test
+ * - BidColumnStore for chronological date values
+ * - SyntheticBids.h for the data
+ * - Bench.h for timing and output
+ *
+ */
+
+#include "LinkedList.h"
+#include "BidColumnStore.h"
+#include "SyntheticBids.h"
+#include "Bench.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    template <typename Compare>
+    void checkOrder(const BidView& view, Compare comparator, const char* name) {
+        for (size_t i = 1; i < view.size(); i++) {
+            if (comparator(view[i], view[i - 1])) {
+                std::fprintf(stderr, "%s: bids out of order at %zu\n", name, i);
+                std::exit(1);
+            }
+        }
+    }
+
+    template <typename Compare>
+    void measure(const char* key, const LinkedList& unsorted, Compare comparator) {
+        size_t count = static_cast<size_t>(unsorted.Size());
+        unsigned int threads = std::max(2u, std::thread::hardware_concurrency());
+        std::printf("by %s\n", key);
+
+        {
+            LinkedList list(unsorted);
+            bench::Stopwatch stopwatch;
+            list.Sort(comparator);
+            bench::Report("  LinkedList::Sort", count, stopwatch.Seconds());
+            checkOrder(BidView(list.Snapshot()), comparator, "Sort");
+        }
+        {
+            LinkedList list(unsorted);
+            bench::Stopwatch stopwatch;
+            list.ParallelSort(comparator, threads);
+            std::string name = "  LinkedList::ParallelSort (" + std::to_string(threads) + " threads)";
+            bench::Report(name.c_str(), count, stopwatch.Seconds());
+            checkOrder(BidView(list.Snapshot()), comparator, "ParallelSort");
+        }
+        {
+            std::shared_ptr<const BidSnapshot> snapshot = unsorted.Snapshot();
+            bench::Stopwatch stopwatch;
+            std::vector<uint32_t> order = snapshot->SortedOrder(comparator);
+            bench::Report("  BidSnapshot::SortedOrder", count, stopwatch.Seconds());
+            checkOrder(BidView(snapshot, std::move(order)), comparator, "SortedOrder");
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t count = bench::Count(argc, argv, 1000000);
+
+    LinkedList unsorted;
+    for (size_t i = 0; i < count; i++) {
+        unsorted.Append(synthetic::MakeBid(i));
+    }
+    std::printf("%zu bids, %u cores\n", count, std::thread::hardware_concurrency());
+
+    measure("winningBid", unsorted, [](const Bid& a, const Bid& b) {
+        return a.winningBid < b.winningBid;
+    });
+    measure("closeDate", unsorted, [](const Bid& a, const Bid& b) {
+        return BidColumnStore::DateValue(a, BidColumnStore::CloseDate) < BidColumnStore::DateValue(b, BidColumnStore::CloseDate);
+    });
+    measure("department", unsorted, [](const Bid& a, const Bid& b) {
+        return a.department.str() < b.department.str();
+    });
+    return 0;
+}
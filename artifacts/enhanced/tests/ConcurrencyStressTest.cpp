@@ -0,0 +1,256 @@
+/*
+ * File: ConcurrencyStressTest.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file stress tests the DatabaseManager's reader/writer concurrency. Writer
+ * threads update, delete and re-add their own bids and add new ones, reading each
+ * change back at once, while reader threads take snapshots, walk keyset pages and
+ * look bids up. Readers check that every snapshot is internally consistent and never
+ * changes under them; at the end every write must be visible and the listing, the
+ * pages, the point lookups and the column totals must all agree. The run is done once
+ * with the store loaded at startup and once while it warms up in the background.
+ *
+ * Dependencies:
+ * - DatabaseManager for the store under test
+ * - SyntheticBids.h for the data
+ *
+ */
+
+#include "DatabaseManager.h"
+#include "SyntheticBids.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define CHECK(condition)                                                                     \
+    do {                                                                                     \
+        if (!(condition)) {                                                                  \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            std::abort();                                                                    \
+        }                                                                                    \
+    } while (0)
+
+static const size_t bidCount = 20000;
+static const size_t writerCount = 3;
+static const size_t readerCount = 4;
+static const size_t bidsPerWriter = 50;
+static const int writerRounds = 8;
+static const size_t addsPerWriter = 40;
+
+static const char* const databasePath = "stress.db";
+
+static void removeDatabase() {
+    for (const char* suffix : { "", "-wal", "-shm" }) {
+        std::remove((std::string(databasePath) + suffix).c_str());
+    }
+    std::remove("stress.store");
+}
+
+// A snapshot must hold each auction ID once, and reading it twice must give the same bids
+static void checkSnapshot(const BidView& view) {
+    std::set<std::string> seen;
+    double total = 0;
+    for (const Bid& bid : view) {
+        CHECK(seen.insert(bid.auctionId).second);
+        total += bid.netSales;
+    }
+    std::this_thread::yield();
+
+    double again = 0;
+    size_t count = 0;
+    for (const Bid& bid : view) {
+        again += bid.netSales;
+        count++;
+    }
+    CHECK(count == seen.size());
+    CHECK(again == total);
+}
+
+// Walk every page of a query and return the auction IDs in page order
+static std::vector<std::string> walkPages(DatabaseManager& db, const BidQuery& query, size_t limit) {
+    std::vector<std::string> ids;
+    std::string cursor;
+    do {
+        BidPage page = db.getBidPage(query, cursor, limit);
+        CHECK(page.bids.size() <= limit);
+        CHECK(page.nextCursor.empty() || page.bids.size() == limit);
+        for (const Bid& bid : page.bids) {
+            ids.push_back(bid.auctionId);
+        }
+        cursor = page.nextCursor;
+    } while (!cursor.empty());
+    return ids;
+}
+
+static void run(bool lazy) {
+    DatabaseManager db(databasePath);
+    db.init(lazy);
+
+    // Each writer owns every writerCount-th bid of the first writerCount * bidsPerWriter,
+    // spread over the table, and remembers the last value it wrote to each
+    std::vector<std::map<std::string, double>> written(writerCount);
+    std::atomic<size_t> writersDone(0);
+    std::atomic<long> reads(0);
+    std::vector<std::thread> threads;
+
+    for (size_t w = 0; w < writerCount; w++) {
+        threads.emplace_back([&, w]() {
+            for (int round = 0; round < writerRounds; round++) {
+                for (size_t k = w; k < writerCount * bidsPerWriter; k += writerCount) {
+                    std::string auctionId = synthetic::AuctionId(k * (bidCount / (writerCount * bidsPerWriter)));
+                    Bid bid = db.getBid(auctionId);
+                    CHECK(bid.auctionId == auctionId);
+
+                    bid.netSales = round * 1000.0 + static_cast<double>(k);
+                    bid.inventoryId = "W" + auctionId + ", R" + std::to_string(round);
+                    if (round % 3 == 1 && k % 4 == 0) {
+                        db.deleteBid(auctionId);
+                        db.addBid(bid);
+                    }
+                    else {
+                        db.updateBid(bid);
+                    }
+                    written[w][auctionId] = bid.netSales;
+
+                    // Every change is visible to the writer as soon as the call returns
+                    CHECK(db.getBid(auctionId).netSales == bid.netSales);
+                    CHECK(db.binarySearchBid(auctionId).netSales == bid.netSales);
+                    BidView byItem = db.getBidsByInventoryId("W" + auctionId);
+                    CHECK(byItem.size() == 1 && byItem[0].netSales == bid.netSales);
+                }
+
+                for (size_t a = 0; a < addsPerWriter / writerRounds; a++) {
+                    size_t i = bidCount + w * addsPerWriter + round * (addsPerWriter / writerRounds) + a;
+                    Bid bid = synthetic::MakeBid(i);
+                    db.addBid(bid);
+                    written[w][bid.auctionId] = bid.netSales;
+                    CHECK(db.getBid(bid.auctionId).auctionId == bid.auctionId);
+                }
+            }
+            writersDone++;
+        });
+    }
+
+    for (size_t r = 0; r < readerCount; r++) {
+        threads.emplace_back([&, r]() {
+            BidQuery byId;
+            BidQuery itsByNetSales;
+            itsByNetSales.AddFilter("department", "ITS");
+            itsByNetSales.SetSort("-netSales");
+
+            while (writersDone < writerCount) {
+                if (r == 0) {
+                    BidView all = db.getAllBids();
+                    CHECK(all.size() + writerCount >= bidCount);
+                    CHECK(all.size() <= bidCount + writerCount * addsPerWriter);
+                    checkSnapshot(all);
+                }
+                else if (r == 1) {
+                    // Keyset pages stay in order across writes and never repeat a bid. A
+                    // walk spans many writes, so it may miss any bid a writer re-adds.
+                    std::vector<std::string> ids = walkPages(db, byId, 997);
+                    for (size_t i = 1; i < ids.size(); i++) {
+                        CHECK(ids[i - 1] < ids[i]);
+                    }
+                    CHECK(ids.size() + writerCount * bidsPerWriter >= bidCount);
+                }
+                else if (r == 2) {
+                    BidPage page = db.getBidPage(itsByNetSales, "", 200);
+                    checkSnapshot(page.bids);
+                    for (size_t i = 0; i < page.bids.size(); i++) {
+                        CHECK(page.bids[i].department.str() == "ITS");
+                        CHECK(i == 0 || page.bids[i - 1].netSales >= page.bids[i].netSales);
+                    }
+                }
+                else {
+                    // A bid being deleted and re-added may be missing for a moment, but a
+                    // lookup never returns some other bid
+                    for (size_t k = 0; k < writerCount * bidsPerWriter; k++) {
+                        std::string auctionId = synthetic::AuctionId(k * (bidCount / (writerCount * bidsPerWriter)));
+                        try {
+                            CHECK(db.getBid(auctionId).auctionId == auctionId);
+                        }
+                        catch (const std::runtime_error&) {
+                        }
+                        Bid found = db.binarySearchBid(auctionId);
+                        CHECK(found.auctionId.empty() || found.auctionId == auctionId);
+                    }
+                    db.getColumnTotals(BidColumnStore::Fund, BidColumnStore::NetSales);
+                }
+                reads++;
+            }
+        });
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    while (!db.getWarmupProgress().ready) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    // Every write is in the store
+    BidView all = db.getAllBids();
+    CHECK(all.size() == bidCount + writerCount * addsPerWriter);
+    checkSnapshot(all);
+    for (const std::map<std::string, double>& values : written) {
+        for (const auto& value : values) {
+            CHECK(db.getBid(value.first).netSales == value.second);
+        }
+    }
+
+    // The pages, the totals and the listing agree
+    std::vector<std::string> ids = walkPages(db, BidQuery(), 1000);
+    CHECK(ids.size() == all.size());
+    std::set<std::string> listed;
+    std::map<std::string, double> byFund;
+    for (const Bid& bid : all) {
+        listed.insert(bid.auctionId);
+        byFund[bid.fund.str()] += bid.netSales;
+    }
+    CHECK(std::set<std::string>(ids.begin(), ids.end()) == listed);
+    for (const auto& total : db.getColumnTotals(BidColumnStore::Fund, BidColumnStore::NetSales)) {
+        CHECK(std::fabs(total.second - byFund[total.first]) <= 1e-6 * (1 + std::fabs(total.second)));
+    }
+
+    std::printf("%s: %ld reads alongside %zu writers\n", lazy ? "lazy" : "eager", reads.load(), writerCount);
+}
+
+// Import the synthetic export into a new database. The store file written on close is
+// removed, so a lazy start warms up from the database itself.
+static void createDatabase() {
+    removeDatabase();
+    {
+        DatabaseManager db(databasePath);
+        db.init();
+        ImportSummary summary = db.importFromCSV("stress.csv");
+        CHECK(summary.imported == bidCount);
+    }
+    std::remove("stress.store");
+}
+
+int main() {
+    synthetic::WriteCSV("stress.csv", bidCount);
+
+    createDatabase();
+    run(false);
+    createDatabase();
+    run(true);
+
+    removeDatabase();
+    std::remove("stress.csv");
+    std::printf("ok\n");
+    return 0;
+}
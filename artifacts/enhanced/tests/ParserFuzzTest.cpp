@@ -0,0 +1,281 @@
+/*
+ * File: ParserFuzzTest.cpp
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file checks the import parsers against a corpus of awkward input and against
+ * generated input. Every CSV line is split with each delimiter scan kernel this CPU
+ * supports (scalar, SSE2, AVX2 and the one picked at runtime), at every alignment
+ * across a 32-byte block, and each must give exactly the fields of a plain
+ * character-by-character split. The number parsers must give the expected result for
+ * every case in the corpus, read back every amount they could have been given by an
+ * export, and fail cleanly on noise.
+ *
+ * Dependencies:
+ * - CSVparser.h for the field splitter
+ * - NumberParsing.h for the money and percent parsers
+ * - SyntheticBids.h for the generator
+ *
+ */
+
+#include "CSVparser.h"
+#include "NumberParsing.h"
+#include "SyntheticBids.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#define CHECK(condition)                                                                     \
+    do {                                                                                     \
+        if (!(condition)) {                                                                  \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            std::abort();                                                                    \
+        }                                                                                    \
+    } while (0)
+
+struct Kernel {
+    csv::ScanKernel kernel;
+    const char* name;
+};
+
+static const Kernel kernels[] = {
+    { csv::ScanKernel::Scalar, "scalar" },
+    { csv::ScanKernel::SSE2, "sse2" },
+    { csv::ScanKernel::AVX2, "avx2" },
+    { csv::ScanKernel::Best, "best" },
+};
+
+static std::vector<Kernel> supported;
+static size_t linesChecked = 0;
+
+// Printable form of a line for failure messages
+static std::string escape(std::string_view text) {
+    std::string escaped;
+    for (unsigned char c : text) {
+        if (c >= 0x20 && c < 0x7f) {
+            escaped += static_cast<char>(c);
+        }
+        else {
+            char hex[8];
+            std::snprintf(hex, sizeof(hex), "\\x%02x", c);
+            escaped += hex;
+        }
+    }
+    return escaped;
+}
+
+// The splitter as it was before the SIMD kernels: a quote toggles quoting and a
+// separator outside quotes ends a field
+static std::vector<std::string_view> referenceSplit(std::string_view line, char sep) {
+    std::vector<std::string_view> fields;
+    bool quoted = false;
+    size_t tokenStart = 0;
+    for (size_t i = 0; i < line.size(); i++) {
+        if (line.at(i) == '"') {
+            quoted = !quoted;
+        }
+        else if (line.at(i) == sep && !quoted) {
+            fields.push_back(line.substr(tokenStart, i - tokenStart));
+            tokenStart = i + 1;
+        }
+    }
+    fields.push_back(line.substr(tokenStart));
+    return fields;
+}
+
+// Split the line with every supported kernel, shifted to each offset within a block
+static void checkLine(const std::string& line, char sep) {
+    std::vector<std::string_view> fields;
+    for (size_t shift = 0; shift <= 32; shift++) {
+        std::string shifted = std::string(shift, 'p') + line;
+        std::vector<std::string_view> expected = referenceSplit(shifted, sep);
+        for (const Kernel& kernel : supported) {
+            csv::splitFields(shifted, sep, fields, kernel.kernel);
+            if (fields != expected) {
+                std::fprintf(stderr, "%s split differs (sep '%c', shift %zu): %s\n", kernel.name, sep, shift,
+                             escape(line).c_str());
+                std::abort();
+            }
+        }
+        linesChecked++;
+    }
+}
+
+static std::vector<std::string> readLines(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    CHECK(in.good());
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(in, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+static void checkCsvCorpus(const std::filesystem::path& directory) {
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+    CHECK(!files.empty());
+
+    for (const std::filesystem::path& file : files) {
+        for (const std::string& line : readLines(file)) {
+            checkLine(line, ',');
+        }
+    }
+}
+
+// Lines made mostly of separators, quotes and bytes with the high bit set, which is
+// where a vector compare or a carried quote state would go wrong
+static void checkGeneratedLines() {
+    static const char alphabet[] = { ',', ',', '"', '"', ';', 'a', 'b', ' ', '\r', '\xff', '\x80', '\xac', '\xa2' };
+    for (uint64_t i = 0; i < 3000; i++) {
+        uint32_t r = synthetic::mix(i);
+        std::string line(r % 200, ' ');
+        for (size_t j = 0; j < line.size(); j++) {
+            line[j] = alphabet[synthetic::mix(i * 1000003 + j) % sizeof(alphabet)];
+        }
+        checkLine(line, (r & 1) ? ',' : ';');
+    }
+}
+
+static bool closeTo(double value, double expected) {
+    return std::fabs(value - expected) <= 1e-12 * (1 + std::fabs(expected));
+}
+
+static void checkNumberCorpus(const std::filesystem::path& path) {
+    size_t cases = 0;
+    for (const std::string& line : readLines(path)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        size_t first = line.find('\t');
+        size_t second = line.find('\t', first + 1);
+        CHECK(first != std::string::npos && second != std::string::npos);
+        std::string kind = line.substr(0, first);
+        std::string text = line.substr(first + 1, second - first - 1);
+        std::string expected = line.substr(second + 1);
+
+        double value = -1;
+        ParseStatus status = kind == "money" ? parseMoney(text, value) : parsePercent(text, value);
+        bool matches;
+        if (expected.compare(0, 3, "ok ") == 0) {
+            matches = status == ParseStatus::Ok && closeTo(value, std::strtod(expected.c_str() + 3, nullptr));
+        }
+        else {
+            matches = status == (expected == "invalid" ? ParseStatus::Invalid : ParseStatus::OutOfRange);
+        }
+        if (!matches) {
+            std::fprintf(stderr, "%s \"%s\": expected %s, got %s %.17g\n", kind.c_str(), escape(text).c_str(),
+                         expected.c_str(), parseStatusMessage(status), value);
+            std::abort();
+        }
+        cases++;
+    }
+    CHECK(cases > 0);
+}
+
+// Write cents in one of the styles found in exports: optional thousands separators,
+// any of the negative forms, and optional quotes and padding
+static std::string formatMoney(long long cents, uint32_t style) {
+    std::string digits = std::to_string(std::llabs(cents) / 100);
+    if (style & 1) {
+        for (size_t i = digits.size(); i > 3; i -= 3) {
+            digits.insert(i - 3, ",");
+        }
+    }
+    char fraction[8];
+    std::snprintf(fraction, sizeof(fraction), ".%02lld", std::llabs(cents) % 100);
+    std::string amount = digits + fraction;
+
+    std::string text;
+    if (cents >= 0) {
+        text = "$" + amount;
+    }
+    else if ((style >> 1) % 3 == 0) {
+        text = "-$" + amount;
+    }
+    else if ((style >> 1) % 3 == 1) {
+        text = "$-" + amount;
+    }
+    else {
+        text = "($" + amount + ")";
+    }
+    if (style & 8) {
+        text = " " + text + " ";
+    }
+    if (style & 16) {
+        text = "\"" + text + "\"";
+    }
+    return text;
+}
+
+static void checkGeneratedNumbers() {
+    for (uint64_t i = 0; i < 200000; i++) {
+        uint32_t r = synthetic::mix(i);
+        long long cents = static_cast<long long>(synthetic::mix(i + 0x9e3779b9) % 1000000000) >> (r % 24);
+        if (r & 32) {
+            cents = -cents;
+        }
+        std::string text = formatMoney(cents, r);
+        double value = 0;
+        if (parseMoney(text, value) != ParseStatus::Ok || !closeTo(value, cents / 100.0)) {
+            std::fprintf(stderr, "money \"%s\" read as %.17g\n", text.c_str(), value);
+            std::abort();
+        }
+
+        std::string percent = std::to_string(r % 10000) + "%";
+        CHECK(parsePercent(percent, value) == ParseStatus::Ok && closeTo(value, (r % 10000) / 100.0));
+    }
+
+    // Noise built from the characters the formats use must never parse to a value
+    // that is not a finite number
+    static const char alphabet[] = "0123456789$,.-()\" %e";
+    for (uint64_t i = 0; i < 200000; i++) {
+        std::string text(synthetic::mix(i) % 24, ' ');
+        for (size_t j = 0; j < text.size(); j++) {
+            text[j] = alphabet[synthetic::mix(i * 131 + j) % (sizeof(alphabet) - 1)];
+        }
+        double value = 0;
+        if (parseMoney(text, value) == ParseStatus::Ok) {
+            CHECK(std::isfinite(value));
+        }
+        if (parsePercent(text, value) == ParseStatus::Ok) {
+            CHECK(std::isfinite(value));
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::filesystem::path corpus = argc > 1 ? argv[1] : "corpus";
+
+    std::ostringstream names;
+    for (const Kernel& kernel : kernels) {
+        if (csv::scanKernelSupported(kernel.kernel)) {
+            supported.push_back(kernel);
+            names << ' ' << kernel.name;
+        }
+    }
+    CHECK(!supported.empty() && supported.front().kernel == csv::ScanKernel::Scalar);
+
+    checkCsvCorpus(corpus / "csv");
+    checkGeneratedLines();
+    checkNumberCorpus(corpus / "numbers.txt");
+    checkGeneratedNumbers();
+
+    std::printf("%zu lines split by%s\n", linesChecked, names.str().c_str());
+    std::printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,130 @@
+/*
+ * File: SyntheticBids.h
+ * Author: Thomas Gallegos
+ * Email: N/A
+ * Date: July 23, 2024
+ * Version: 1.0
+ *
+ * Purpose:
+ * This file generates deterministic bids shaped like the eBid monthly sales export,
+ * for the tests and benchmarks. Bid i always has the same fields, so runs can be
+ * compared; auction IDs are unique and zero-padded, so their string order is their
+ * numeric order. Every seventh bid lists several inventory IDs in a quoted field,
+ * as multi-item lots do in the real export.
+ *
+ * Dependencies:
+ * - Bid.h for the bid structure
+ *
+ */
+
+#pragma once
+#include "Bid.h"
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+
+namespace synthetic {
+
+    static const char* const departments[] = { "ITS", "Police", "Fire", "Parks and Recreation", "Public Works", "Library" };
+    static const char* const payStatuses[] = { "Successful", "Pending", "Cancelled" };
+    static const char* const funds[] = { "General Fund", "Enterprise Fund", "Special Revenue" };
+    static const char* const items[] = { "Dell Laptop", "Office Chair", "Ford F150 Truck", "HP Printer", "Optiplex Desktop", "Steel Desk" };
+
+    // Small fast generator so the values do not depend on the standard library's engines
+    inline uint32_t mix(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return static_cast<uint32_t>(x);
+    }
+
+    inline std::string AuctionId(size_t i) {
+        char id[16];
+        std::snprintf(id, sizeof(id), "%09zu", i);
+        return id;
+    }
+
+    // MM/DD/YYYY between 2013 and 2024
+    inline std::string Date(uint32_t r) {
+        char date[16];
+        std::snprintf(date, sizeof(date), "%02u/%02u/%04u", r % 12 + 1, (r >> 4) % 28 + 1, 2013 + (r >> 9) % 12);
+        return date;
+    }
+
+    inline Bid MakeBid(size_t i) {
+        uint32_t r = mix(i);
+        Bid bid;
+        bid.auctionTitle = std::to_string(r % 40 + 1) + " " + items[r % 6] + " lot " + std::to_string(i % 1000);
+        bid.auctionId = AuctionId(i);
+        bid.department = departments[(r >> 3) % 6];
+        bid.closeDate = Date(mix(i + 1));
+        bid.winningBid = static_cast<double>(r % 500000) / 100.0;
+        bid.feePercent = 0.23;
+        bid.ccFee = static_cast<double>(static_cast<long>(bid.winningBid * 2.3)) / 100.0;
+        bid.auctionFeeSubtotal = static_cast<double>(static_cast<long>(bid.winningBid * 23.0)) / 100.0;
+        bid.auctionFeeTotal = bid.auctionFeeSubtotal;
+        bid.payStatus = payStatuses[(r >> 7) % 3];
+        bid.paidDate = Date(mix(i + 2));
+        bid.assetNumber = (r % 3 == 0) ? "" : "A" + std::to_string(r % 100000);
+        if (i % 7 == 0) {
+            bid.inventoryId = std::to_string(70000 + i) + ", " + std::to_string(80000 + i) + ", " + std::to_string(90000 + i);
+        }
+        else {
+            bid.inventoryId = std::to_string(70000 + i);
+        }
+        bid.vtrNumber = (r % 5 == 0) ? "V" + std::to_string(r % 9973) : "";
+        bid.receiptNumber = std::to_string(3600000000ULL + r);
+        bid.cap = 3000;
+        bid.expenses = 0;
+        bid.netSales = bid.winningBid - bid.auctionFeeTotal;
+        bid.fund = funds[(r >> 11) % 3];
+        bid.businessUnit = std::to_string((r >> 13) % 4);
+        return bid;
+    }
+
+    // Quote a field if it holds a separator or a quote, doubling any quotes
+    inline std::string CsvField(const std::string& value) {
+        if (value.find_first_of(",\"") == std::string::npos) {
+            return value;
+        }
+        std::string quoted = "\"";
+        for (char c : value) {
+            quoted += c;
+            if (c == '"') {
+                quoted += '"';
+            }
+        }
+        return quoted + "\"";
+    }
+
+    inline std::string Money(double value) {
+        char text[32];
+        std::snprintf(text, sizeof(text), "$%.2f", value);
+        return text;
+    }
+
+    // Write bids [first, first + count) as an export with the real file's header
+    inline void WriteCSV(const std::string& path, size_t count, size_t first = 0) {
+        std::ofstream out(path, std::ios::binary);
+        if (!out) {
+            throw std::runtime_error("Cannot write " + path);
+        }
+        out << "Auction Title ,Auction ID,Department ,Close Date ,Winning Bid ,CC Fee,Fee Percent,Auction Fee Subtotal,"
+               "Auction Fee Total,Pay Status ,Paid Date ,Asset #,Inventory ID,Decal /Vehicle ID,VTR Number,Receipt Number ,"
+               "Cap,Expenses,Net Sales,Fund,Business Unit\n";
+        for (size_t i = first; i < first + count; i++) {
+            Bid bid = MakeBid(i);
+            out << CsvField(bid.auctionTitle) << ',' << bid.auctionId << ',' << bid.department.str() << ','
+                << bid.closeDate << ',' << Money(bid.winningBid) << ',' << Money(bid.ccFee) << ',' << bid.feePercent << ','
+                << Money(bid.auctionFeeSubtotal) << ',' << Money(bid.auctionFeeTotal) << ',' << bid.payStatus.str() << ','
+                << bid.paidDate << ',' << bid.assetNumber << ',' << CsvField(bid.inventoryId) << ",," << bid.vtrNumber << ','
+                << bid.receiptNumber << ",$3000," << Money(bid.expenses) << ',' << Money(bid.netSales) << ','
+                << bid.fund.str() << ',' << bid.businessUnit.str() << '\n';
+        }
+    }
+}